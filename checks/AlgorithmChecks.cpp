@@ -0,0 +1,404 @@
+// Standalone checks of the graph algorithms against simple reference
+// implementations. Built as the algorithm_checks target and run by ctest; exits
+// non-zero after printing every failed check.
+#include "algorithms/Ford-Fulkerson.hpp"
+#include "algorithms/DisjointSet.hpp"
+#include "algorithms/PathFinding.hpp"
+#include "algorithms/ContractionHierarchy.hpp"
+#include "algorithms/LandmarkIndex.hpp"
+#include "algorithms/DeltaStepping.hpp"
+#include "algorithms/DistanceMatrix.hpp"
+#include "algorithms/MSTSelector.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Capacity limits on every arc and conservation at every node but the
+// terminals, which must send and receive exactly the flow value.
+bool isValidFlow(const FlowNetwork& network, int source, int sink, double value) {
+    std::vector<double> balance(network.nodeCount(), 0.0);
+    for (int edge = 0; edge < network.edgeCount(); ++edge) {
+        const double flow = network.getFlow(edge);
+        const int arc = network.getEdgeArc(edge);
+        if (flow > network.getArcCapacity(arc) + 1e-6) return false;
+        if (-flow > network.getArcCapacity(network.getPartner(arc)) + 1e-6) return false;
+        balance[network.getTail(arc)] -= flow;
+        balance[network.getHead(arc)] += flow;
+    }
+    for (int node = 0; node < network.nodeCount(); ++node) {
+        double expected = 0.0;
+        if (node == source) expected = -value;
+        if (node == sink) expected = value;
+        if (std::abs(balance[node] - expected) > 1e-6) return false;
+    }
+    return true;
+}
+
+// Every max-flow solver, run to completion and stepped through begin() and
+// step() as the visualization does, against Edmonds-Karp.
+void checkMaxFlow() {
+    std::mt19937 rng(7);
+    ThreadPool pool(4);
+    constexpr int STEP_LIMIT = 1000000;
+
+    for (int trial = 0; trial < 300; ++trial) {
+        const int nodeCount = 2 + static_cast<int>(rng() % 60);
+        const int edgeCount = static_cast<int>(rng() % 400);
+        FlowNetwork network;
+        network.clear(nodeCount);
+        for (int i = 0; i < edgeCount; ++i) {
+            const int tail = static_cast<int>(rng() % nodeCount);
+            const int head = static_cast<int>(rng() % nodeCount);
+            const double reverse = trial % 3 == 0 ? static_cast<double>(rng() % 10) : 0.0;
+            network.addEdge(tail, head, static_cast<double>(rng() % 20), reverse);
+        }
+        network.finalize();
+
+        const int source = static_cast<int>(rng() % nodeCount);
+        const int sink = (source + 1 + static_cast<int>(rng() % (nodeCount - 1))) % nodeCount;
+        const std::string name = "trial " + std::to_string(trial);
+
+        EdmondsKarp reference;
+        const double expected = reference.solve(network, source, sink);
+
+        auto checkSolver = [&](MaxFlowAlgorithm& solver, bool stepped) {
+            const std::string label = name + ": " + solver.getName() + (stepped ? " (stepped)" : "");
+            double flow = 0.0;
+            if (stepped) {
+                solver.begin(network, source, sink);
+                int steps = 0;
+                while (solver.step() && ++steps < STEP_LIMIT) {}
+                check(solver.isFinished(), label + " did not finish");
+                flow = solver.getFlowValue();
+            } else {
+                flow = solver.solve(network, source, sink);
+            }
+
+            check(flow == expected, label + " flow " + std::to_string(flow) +
+                                    " differs from Edmonds-Karp " + std::to_string(expected));
+            check(isValidFlow(network, source, sink, flow), label + " left an invalid flow");
+            const MinCut cut = solver.getMinCut();
+            check(std::abs(cut.capacity - flow) < 1e-6, label + " min cut capacity differs from the flow");
+            check(cut.sourceSide[source] && !cut.sourceSide[sink], label + " min cut does not separate the terminals");
+        };
+
+        // Stepping refreshes every visual state per step, so only some trials
+        // are also stepped
+        const int modes = trial % 4 == 0 ? 2 : 1;
+        for (int mode = 0; mode < modes; ++mode) {
+            const bool stepped = mode == 1;
+            EdmondsKarp edmondsKarp;
+            Dinic dinic;
+            PushRelabel pushRelabel;
+            ParallelPushRelabel parallel(trial % 2 ? &pool : nullptr);
+            checkSolver(edmondsKarp, stepped);
+            checkSolver(dinic, stepped);
+            checkSolver(pushRelabel, stepped);
+            checkSolver(parallel, stepped);
+        }
+    }
+}
+
+// Unites the same random pairs concurrently and with DisjointSet. Both must
+// report the same number of merges and the same partition, and every
+// concurrent root must be the smallest node of its set.
+void checkConcurrentDisjointSet() {
+    std::mt19937 rng(11);
+    ThreadPool pool(4);
+
+    for (int trial = 0; trial < 50; ++trial) {
+        const int nodeCount = 1 + static_cast<int>(rng() % 5000);
+        const size_t pairCount = rng() % (2 * static_cast<size_t>(nodeCount));
+        std::vector<std::pair<int, int>> pairs(pairCount);
+        for (auto& pair : pairs) {
+            pair = {static_cast<int>(rng() % nodeCount), static_cast<int>(rng() % nodeCount)};
+        }
+        const std::string name = "trial " + std::to_string(trial);
+
+        DisjointSet sequential(nodeCount);
+        size_t expectedMerges = 0;
+        for (const auto& [a, b] : pairs) {
+            if (sequential.unite(a, b)) ++expectedMerges;
+        }
+
+        ConcurrentDisjointSet concurrent(nodeCount);
+        std::atomic<size_t> merges{0};
+        pool.parallelFor(pairs.size(), [&](size_t begin, size_t end, size_t) {
+            size_t local = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (concurrent.unite(pairs[i].first, pairs[i].second)) ++local;
+            }
+            merges.fetch_add(local);
+        });
+        check(merges.load() == expectedMerges, name + ": concurrent unite reported " +
+                                               std::to_string(merges.load()) + " merges, expected " +
+                                               std::to_string(expectedMerges));
+
+        std::vector<int> rootOf(nodeCount, -1);
+        bool samePartition = true;
+        bool smallestRoots = true;
+        for (int node = 0; node < nodeCount; ++node) {
+            const int root = concurrent.find(node);
+            if (root > node) smallestRoots = false;
+            int& mapped = rootOf[sequential.find(node)];
+            if (mapped < 0) mapped = root;
+            if (mapped != root) samePartition = false;
+        }
+        check(samePartition, name + ": concurrent sets differ from DisjointSet");
+        check(smallestRoots, name + ": a concurrent root is not the smallest node of its set");
+    }
+}
+
+}
+
+// A random graph with coordinates for the geographic heuristic. Arc lengths
+// are at least the great-circle distance between their ends, often more.
+struct RandomSearchGraph {
+    std::vector<int> tails;
+    std::vector<int> heads;
+    std::vector<float> weights;
+    std::vector<Coordinates> coordinates;
+    AdjacencyIndex forward;
+    AdjacencyIndex reverse;
+    SearchGraph graph;
+
+    RandomSearchGraph(std::mt19937& rng, bool undirected) {
+        const int nodeCount = 2 + static_cast<int>(rng() % 60);
+        const int arcCount = static_cast<int>(rng() % 250);
+        for (int i = 0; i < nodeCount; ++i) {
+            coordinates.emplace_back(49.5 + (rng() % 1000) / 2000.0, 6.0 + (rng() % 1000) / 2000.0);
+        }
+        for (int i = 0; i < arcCount; ++i) {
+            const int tail = static_cast<int>(rng() % nodeCount);
+            const int head = static_cast<int>(rng() % nodeCount);
+            const double length = coordinates[tail].haversineDistanceTo(coordinates[head]);
+            tails.push_back(tail);
+            heads.push_back(head);
+            weights.push_back(static_cast<float>(std::ceil(length * (1.0 + (rng() % 100) / 100.0))));
+        }
+        forward.build(nodeCount, tails, heads, weights);
+        reverse.build(nodeCount, heads, tails, weights);
+        graph = {&forward, &reverse, undirected};
+    }
+
+    int nodeCount() const { return static_cast<int>(coordinates.size()); }
+};
+
+bool sameDistance(float actual, float expected) {
+    if (expected >= SearchWorkspace::INFINITE_DISTANCE) return actual >= SearchWorkspace::INFINITE_DISTANCE;
+    return std::abs(actual - expected) <= 1e-3f * std::max(1.0f, expected);
+}
+
+// The path must run from source to target over arcs of the graph and add up
+// to the reported distance, which must be the Dijkstra distance.
+void checkPath(const RandomSearchGraph& random, const PathResult& path, const PathResult& expected,
+               int source, int target, const std::string& name) {
+    check(path.found == expected.found, name + ": found " + std::to_string(path.found) +
+                                        ", Dijkstra found " + std::to_string(expected.found));
+    if (!path.found || !expected.found) return;
+    check(sameDistance(path.distance, expected.distance),
+          name + ": distance " + std::to_string(path.distance) + ", Dijkstra " + std::to_string(expected.distance));
+
+    bool valid = path.nodes.size() == path.edgeIds.size() + 1 &&
+                 path.nodes.front() == source && path.nodes.back() == target;
+    float length = 0.0f;
+    for (size_t i = 0; valid && i < path.edgeIds.size(); ++i) {
+        const int edge = path.edgeIds[i];
+        const int from = path.nodes[i];
+        const int to = path.nodes[i + 1];
+        valid = (random.tails[edge] == from && random.heads[edge] == to) ||
+                (random.graph.undirected && random.tails[edge] == to && random.heads[edge] == from);
+        length += random.weights[edge];
+    }
+    check(valid && sameDistance(length, path.distance), name + ": returned path is not a valid path");
+}
+
+// Every point-to-point search, the hierarchy (also after a save/load round
+// trip), ALT with both landmark selections, delta-stepping and both
+// many-to-many modes against plain Dijkstra.
+void checkShortestPaths() {
+    std::mt19937 rng(5);
+    ThreadPool pool(4);
+    const std::string hierarchyFile = "algorithm_checks.ch";
+
+    for (int trial = 0; trial < 200; ++trial) {
+        const bool undirected = trial % 2 == 1;
+        const RandomSearchGraph random(rng, undirected);
+        const SearchGraph& graph = random.graph;
+        const int nodeCount = random.nodeCount();
+        const std::string name = "trial " + std::to_string(trial) + (undirected ? " undirected" : " directed");
+
+        std::vector<int> ids(nodeCount);
+        for (int i = 0; i < nodeCount; ++i) ids[i] = i;
+        ContractionHierarchy hierarchy;
+        hierarchy.build(graph, ids);
+        hierarchy.saveToFile(hierarchyFile);
+        ContractionHierarchy loaded;
+        loaded.loadFromFile(hierarchyFile, nodeCount);
+
+        LandmarkIndex farthest;
+        farthest.build(graph, 1 + static_cast<int>(rng() % 6), LandmarkIndex::Selection::FARTHEST);
+        LandmarkIndex avoid;
+        avoid.build(graph, 1 + static_cast<int>(rng() % 6), LandmarkIndex::Selection::AVOID);
+
+        const GeoHeuristic geo = GeoHeuristic::fromCoordinates(random.coordinates, random.forward);
+        Dijkstra dijkstra(graph);
+        AStar aStar(graph, geo);
+        BidirectionalAStar bidirectionalAStar(graph, geo);
+        BidirectionalDijkstra bidirectionalDijkstra(graph);
+        ALTSearch altFarthest(graph, farthest);
+        ALTSearch altAvoid(graph, avoid);
+
+        for (int query = 0; query < 20; ++query) {
+            const int source = static_cast<int>(rng() % nodeCount);
+            const int target = static_cast<int>(rng() % nodeCount);
+            const PathResult expected = dijkstra.findPath(source, target);
+            const std::string queryName = name + " " + std::to_string(source) + "->" + std::to_string(target);
+
+            checkPath(random, aStar.findPath(source, target), expected, source, target, queryName + " A*");
+            checkPath(random, bidirectionalAStar.findPath(source, target), expected, source, target,
+                      queryName + " bidirectional A*");
+            checkPath(random, bidirectionalDijkstra.findPath(source, target), expected, source, target,
+                      queryName + " bidirectional Dijkstra");
+            checkPath(random, hierarchy.findPath(source, target), expected, source, target, queryName + " CH");
+            checkPath(random, loaded.findPath(source, target), expected, source, target, queryName + " loaded CH");
+            checkPath(random, altFarthest.findPath(source, target), expected, source, target,
+                      queryName + " ALT farthest");
+            checkPath(random, altAvoid.findPath(source, target), expected, source, target, queryName + " ALT avoid");
+        }
+
+        const int source = static_cast<int>(rng() % nodeCount);
+        dijkstra.computeAll(source);
+        const SearchWorkspace& reference = dijkstra.getWorkspace();
+        auto referenceDistance = [&](int node) {
+            return reference.isReached(node) ? reference.getDistance(node) : SearchWorkspace::INFINITE_DISTANCE;
+        };
+        for (ThreadPool* deltaPool : {static_cast<ThreadPool*>(nullptr), &pool}) {
+            DeltaStepping deltaStepping(deltaPool);
+            deltaStepping.compute(graph, source);
+            bool matches = true;
+            for (int node = 0; node < nodeCount; ++node) {
+                matches = matches && sameDistance(deltaStepping.getDistance(node), referenceDistance(node));
+            }
+            check(matches, name + (deltaPool ? " delta-stepping with a pool" : " delta-stepping") +
+                           " differs from Dijkstra");
+        }
+
+        std::vector<int> sources(1 + rng() % 8);
+        std::vector<int> targets(1 + rng() % 8);
+        for (int& node : sources) node = static_cast<int>(rng() % nodeCount);
+        for (int& node : targets) node = static_cast<int>(rng() % nodeCount);
+        for (ThreadPool* matrixPool : {static_cast<ThreadPool*>(nullptr), &pool}) {
+            ManyToManySearch manyToMany(matrixPool);
+            DistanceMatrix viaHierarchy;
+            DistanceMatrix viaDijkstra;
+            manyToMany.compute(hierarchy, sources, targets, viaHierarchy);
+            manyToMany.compute(graph, sources, targets, viaDijkstra);
+
+            bool hierarchyMatches = true;
+            bool dijkstraMatches = true;
+            for (size_t row = 0; row < sources.size(); ++row) {
+                for (size_t column = 0; column < targets.size(); ++column) {
+                    const PathResult expected = dijkstra.findPath(sources[row], targets[column]);
+                    const float distance = expected.found ? expected.distance : SearchWorkspace::INFINITE_DISTANCE;
+                    hierarchyMatches = hierarchyMatches && sameDistance(viaHierarchy.at(row, column), distance);
+                    dijkstraMatches = dijkstraMatches && sameDistance(viaDijkstra.at(row, column), distance);
+                }
+            }
+            const std::string mode = matrixPool ? " with a pool" : "";
+            check(hierarchyMatches, name + ": many-to-many over the hierarchy" + mode + " differs from Dijkstra");
+            check(dijkstraMatches, name + ": many-to-many Dijkstra" + mode + " differs from Dijkstra");
+        }
+    }
+
+    std::remove(hierarchyFile.c_str());
+}
+
+// The selector stays on Filter-Kruskal until a multi-core measurement says
+// otherwise, and both non-visual MST paths, with and without a pool, find a
+// forest of the same weight as a plain sorted Kruskal.
+void checkMSTSelector() {
+    const size_t nodeCounts[] = {0, 2, 100, 100000};
+    const size_t averageDegrees[] = {1, 4, 8, 16, 64};
+    const size_t threadCounts[] = {1, 2, 4, 8, 64};
+    for (size_t nodeCount : nodeCounts) {
+        for (size_t degree : averageDegrees) {
+            for (size_t threads : threadCounts) {
+                const MSTMethod method = chooseMSTMethod(nodeCount, nodeCount * degree / 2, threads);
+                check(method == MSTMethod::FILTER_KRUSKAL,
+                      "chooseMSTMethod(" + std::to_string(nodeCount) + ", degree " + std::to_string(degree) +
+                      ", " + std::to_string(threads) + " threads) picked " + getMSTMethodName(method));
+            }
+        }
+    }
+
+    std::mt19937 rng(17);
+    ThreadPool pool(4);
+    for (int trial = 0; trial < 100; ++trial) {
+        const int nodeCount = 1 + static_cast<int>(rng() % 300);
+        const size_t edgeCount = rng() % (8 * static_cast<size_t>(nodeCount));
+        std::vector<WeightedEdge> edges(edgeCount);
+        for (size_t i = 0; i < edgeCount; ++i) {
+            edges[i] = {static_cast<int>(rng() % nodeCount), static_cast<int>(rng() % nodeCount),
+                        static_cast<float>(rng() % 50), static_cast<int>(i)};
+        }
+
+        std::vector<WeightedEdge> sorted = edges;
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const WeightedEdge& a, const WeightedEdge& b) { return a.weight < b.weight; });
+        DisjointSet forest(nodeCount);
+        double expected = 0.0;
+        size_t expectedEdges = 0;
+        for (const WeightedEdge& edge : sorted) {
+            if (forest.unite(edge.src, edge.dest)) {
+                expected += edge.weight;
+                ++expectedEdges;
+            }
+        }
+
+        for (MSTMethod method : {MSTMethod::FILTER_KRUSKAL, MSTMethod::PARALLEL_BORUVKA}) {
+            for (ThreadPool* threadPool : {static_cast<ThreadPool*>(nullptr), &pool}) {
+                auto algorithm = createMSTAlgorithm(method);
+                for (const WeightedEdge& edge : edges) algorithm->addEdge(edge.src, edge.dest, edge.weight);
+                const auto& tree = runMSTMethod(*algorithm, method, threadPool);
+
+                double total = 0.0;
+                for (const WeightedEdge& edge : tree) total += edge.weight;
+                const std::string name = "trial " + std::to_string(trial) + " " + getMSTMethodName(method) +
+                                         (threadPool ? " with pool" : " without pool");
+                check(tree.size() == expectedEdges, name + ": forest edge count");
+                check(std::abs(total - expected) < 1e-3, name + ": forest weight");
+            }
+        }
+    }
+}
+
+int main() {
+    checkMaxFlow();
+    checkConcurrentDisjointSet();
+    checkShortestPaths();
+    checkMSTSelector();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Compressed sparse row view of a graph's arcs. Node indices are positions in
+// Graph::getNodes(), edge ids are positions in Graph::getEdges().
+struct AdjacencyIndex {
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<float> weights;
+    std::vector<int> edgeIds;
+
+    size_t nodeCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t arcCount() const { return targets.size(); }
+
+    int begin(int node) const { return offsets[node]; }
+    int end(int node) const { return offsets[node + 1]; }
+    int degree(int node) const { return offsets[node + 1] - offsets[node]; }
+
+    void clear() {
+        offsets.assign(1, 0);
+        targets.clear();
+        weights.clear();
+        edgeIds.clear();
+    }
+
+    // Counting-sort build: arcs keep their input order within each row.
+    void build(size_t numNodes, const std::vector<int>& tails, const std::vector<int>& heads,
+               const std::vector<float>& arcWeights) {
+        offsets.assign(numNodes + 1, 0);
+        for (int tail : tails) {
+            offsets[tail + 1]++;
+        }
+        for (size_t i = 0; i < numNodes; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        targets.resize(tails.size());
+        weights.resize(tails.size());
+        edgeIds.resize(tails.size());
+
+        std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t arc = 0; arc < tails.size(); ++arc) {
+            int slot = cursor[tails[arc]]++;
+            targets[slot] = heads[arc];
+            weights[slot] = arcWeights[arc];
+            edgeIds[slot] = static_cast<int>(arc);
+        }
+    }
+};
@@ -10,8 +10,13 @@
 #include <sstream>
 #include <map>
 #include <iostream>
+#include <chrono>
+#include <cstdio>
 #include "algorithms/KruskalMST.hpp"
 #include "algorithms/BoruvkaMST.hpp"
+#include "algorithms/PrimMST.hpp"
+#include "algorithms/MSTSelector.hpp"
+#include "algorithms/Ford-Fulkerson.hpp"
 #include "GraphIO.hpp"
 
 class AlgorithmPanel {
@@ -52,6 +57,21 @@ public:
                     sf::Vector2f(buttonWidth, buttonHeight),
                     [this]() { selectAlgorithm("Boruvka"); });
 
+        buttonY += buttonSpacing;
+        createButton("Prim's Algorithm", sf::Vector2f(x + 10, buttonY),
+                    sf::Vector2f(buttonWidth, buttonHeight),
+                    [this]() { selectAlgorithm("Prim"); });
+
+        buttonY += buttonSpacing;
+        createButton("Fastest MST", sf::Vector2f(x + 10, buttonY),
+                    sf::Vector2f(buttonWidth, buttonHeight),
+                    [this]() { runFastestMST(); });
+
+        buttonY += buttonSpacing;
+        createButton("Max Flow / Min Cut", sf::Vector2f(x + 10, buttonY),
+                    sf::Vector2f(buttonWidth, buttonHeight),
+                    [this]() { runMinCut(); });
+
         if (font.loadFromFile("resources/Roboto-Medium.ttf")) {
             status.setFont(font);
             status.setCharacterSize(14);
@@ -176,6 +196,9 @@ private:
             } else if (algorithmName == "Boruvka") {
                 std::cout << "Creating Boruvka's algorithm instance" << std::endl;
                 currentAlgorithm = std::make_unique<BoruvkaMST>();
+            } else if (algorithmName == "Prim") {
+                std::cout << "Creating Prim's algorithm instance" << std::endl;
+                currentAlgorithm = std::make_unique<PrimMST>();
             }
 
             if (currentAlgorithm) {
@@ -194,13 +217,65 @@ private:
         loadAlgorithmGraph(name);
     }
 
-    void prepareAlgorithm() {
-        if (!currentAlgorithm || !graph) return;
+    // Runs push-relabel on the graph as it is, from the selected node (or the
+    // first one) to the last node, and shows the minimum cut it leaves.
+    void runMinCut() {
+        if (!graph || graph->getNodes().size() < 2) return;
+        stopAnimation();
+        currentAlgorithm.reset();
 
-        currentAlgorithm->reset();
-        nodeStates.clear();
+        const auto& nodes = graph->getNodes();
+        const int lastNode = static_cast<int>(nodes.size()) - 1;
+        int source = 0;
+        for (int i = 0; i <= lastNode; ++i) {
+            if (nodes[i]->isSelected()) source = i;
+        }
+        const int sink = source == lastNode ? 0 : lastNode;
+
+        FlowNetwork network = FlowNetwork::fromGraph(*graph);
+        PushRelabel solver;
+        const FlowNetwork::Capacity flow = solver.solve(network, source, sink);
+        const MinCut cut = solver.getMinCut();
+        highlightMinCut(*graph, network, cut);
+
+        std::ostringstream summary;
+        summary << "Max flow from node " << nodes[source]->getId() << " to node " << nodes[sink]->getId()
+                << ": " << flow << ", cut of " << cut.edges.size() << " edge(s)";
+        status.setString(summary.str());
+        wrapText(status, panel.getSize().x - 20);
+        description.setString(solver.getDescription());
+        wrapText(description, panel.getSize().x - 20);
+    }
 
+    // Skips the step log: runs the non-visual MST path chosen for the graph
+    // as it is and shows the finished tree.
+    void runFastestMST() {
+        if (!graph) return;
+        stopAnimation();
+
+        size_t edgeCount = 0;
+        for (const auto& edge : graph->getEdges()) {
+            if (edge->getWeight()) ++edgeCount;
+        }
+        const MSTMethod method = chooseMSTMethod(graph->getNodes().size(), edgeCount,
+                                                 graph->getLayoutThreadCount());
+        currentAlgorithm = createMSTAlgorithm(method);
+        addGraphEdges();
+
+        auto start = std::chrono::steady_clock::now();
+        runMSTMethod(*currentAlgorithm, method, graph->getLayoutPool());
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        updateGraphHighlights();
+        char timing[32];
+        std::snprintf(timing, sizeof(timing), "%.1f ms", elapsed.count());
+        status.setString(getMSTMethodName(method) + ": " +
+                         std::to_string(currentAlgorithm->getMSTEdges().size()) + " edges in " + timing);
+        description.setString(currentAlgorithm->getDescription());
+        wrapText(description, panel.getSize().x - 20);
+    }
 
+    void addGraphEdges() {
         for (const auto& edge : graph->getEdges()) {
             if (edge->getWeight()) {
                 currentAlgorithm->addEdge(
@@ -210,6 +285,14 @@ private:
                 );
             }
         }
+    }
+
+    void prepareAlgorithm() {
+        if (!currentAlgorithm || !graph) return;
+
+        currentAlgorithm->reset();
+        nodeStates.clear();
+        addGraphEdges();
 
 
         currentAlgorithm->execute(graph->getNodes());
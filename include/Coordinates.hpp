@@ -1,5 +1,7 @@
 #pragma once
+#include <SFML/Graphics.hpp>
 #include <cmath>
+#include <algorithm>
 
 struct Coordinates {
     double latitude;
@@ -26,4 +28,25 @@ struct Coordinates {
         double dy = latitude - other.latitude;
         return std::sqrt(dx * dx + dy * dy);
     }
+
+    // Great-circle distance in metres.
+    double haversineDistanceTo(const Coordinates& other) const {
+        double lat1 = latitude * DEGREES_TO_RADIANS;
+        double lat2 = other.latitude * DEGREES_TO_RADIANS;
+        return haversineRadians(lat1, longitude * DEGREES_TO_RADIANS, std::cos(lat1),
+                                lat2, other.longitude * DEGREES_TO_RADIANS, std::cos(lat2));
+    }
+
+    // The same distance from angles already in radians, with the cosines of
+    // the latitudes passed in so callers that measure often can cache them.
+    static double haversineRadians(double lat1, double lon1, double cosLat1,
+                                   double lat2, double lon2, double cosLat2) {
+        double sinLat = std::sin((lat2 - lat1) / 2);
+        double sinLon = std::sin((lon2 - lon1) / 2);
+        double a = sinLat * sinLat + cosLat1 * cosLat2 * sinLon * sinLon;
+        return 2 * EARTH_RADIUS_METRES * std::asin(std::sqrt(std::min(1.0, a)));
+    }
+
+    static constexpr double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+    static constexpr double EARTH_RADIUS_METRES = 6371008.8;
 };
\ No newline at end of file
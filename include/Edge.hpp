@@ -2,54 +2,39 @@
 #include <SFML/Graphics.hpp>
 #include "Node.hpp"
 #include "Theme.hpp"
+#include "GlyphLayout.hpp"
 #include <math.h>
 #include <optional>
+#include <array>
+#include <vector>
+#include <cstdint>
 #include <string>
 #include <iomanip>
 #include <sstream>
 
+// Geometry is kept as a fixed block of VERTEX_COUNT triangle vertices (glow,
+// line, arrow) so EdgeBatchRenderer can copy it into a shared slot. The weight
+// label is kept as glyph quads relative to getLabelPosition().
 class Edge {
 public:
+    static constexpr size_t GLOW_OFFSET = 0;
+    static constexpr size_t LINE_OFFSET = 6;
+    static constexpr size_t ARROW_OFFSET = 12;
+    static constexpr size_t VERTEX_COUNT = 15;
+    static constexpr unsigned int LABEL_CHARACTER_SIZE = 14;
+
     Edge(Node* start, Node* end, bool isDirected = false, std::optional<float> weight = std::nullopt)
         : startNode(start), endNode(end), directed(isDirected), showArrow(isDirected),
           weight(weight), isHighlighted(false) {
 
-        line.setPrimitiveType(sf::Quads);
-        line.resize(4);
-
-        glow.setPrimitiveType(sf::Quads);
-        glow.resize(4);
-
-        arrowHead.setPrimitiveType(sf::Triangles);
-        arrowHead.resize(3);
-
         if (weight.has_value() && !fontLoaded) {
             if (font.loadFromFile("resources/Roboto-Medium.ttf")) {
                 fontLoaded = true;
             }
         }
 
-        if (weight.has_value() && fontLoaded) {
-            weightText.setFont(font);
-            weightText.setCharacterSize(14);
-            weightText.setFillColor(sf::Color::White);
-            updateWeightText();
-        }
-
-        updateVertices();
-    }
-
-    void draw(sf::RenderTarget& target, const sf::RenderStates& states) {
-        // Draw glow effect first
-        target.draw(glow, states);
-        // Then draw the main line
-        target.draw(line, states);
-        if (showArrow) {
-            target.draw(arrowHead, states);
-        }
-        if (weight.has_value() && fontLoaded) {
-            target.draw(weightText, states);
-        }
+        updateWeightText();
+        update();
     }
 
     void setDirected(bool isDirected) {
@@ -73,13 +58,23 @@ public:
         updateWeightText();
     }
 
-    void update() {
-        if (startNode && endNode) {
-            updateVertices();
-            if (weight.has_value()) {
-                updateWeightText();
-            }
+    // Rebuilds the geometry only if an endpoint moved since the last call.
+    // Returns true when it did.
+    bool update() {
+        if (!startNode || !endNode) return false;
+
+        std::uint32_t startVersion = startNode->getPositionVersion();
+        std::uint32_t endVersion = endNode->getPositionVersion();
+        if (geometryBuilt && startVersion == cachedStartVersion && endVersion == cachedEndVersion) {
+            return false;
         }
+
+        cachedStartVersion = startVersion;
+        cachedEndVersion = endVersion;
+        geometryBuilt = true;
+        updateVertices();
+        updateWeightTextPosition();
+        return true;
     }
 
     std::optional<float> getWeight() const { return weight; }
@@ -90,6 +85,13 @@ public:
     bool isShowingArrow() const { return showArrow; }
     bool isHighlightedEdge() const { return isHighlighted; }
 
+    // Bumped whenever the geometry or the label changes.
+    std::uint32_t getRevision() const { return revision; }
+    const std::array<sf::Vertex, VERTEX_COUNT>& getVertices() const { return vertices; }
+    const std::vector<sf::Vertex>& getLabelVertices() const { return labelVertices; }
+    sf::Vector2f getLabelPosition() const { return labelPosition; }
+    static const sf::Texture& getLabelTexture() { return font.getTexture(LABEL_CHARACTER_SIZE); }
+
 private:
     Node* startNode;
     Node* endNode;
@@ -97,10 +99,13 @@ private:
     bool showArrow;
     bool isHighlighted;
     std::optional<float> weight;
-    sf::VertexArray line;
-    sf::VertexArray glow;
-    sf::VertexArray arrowHead;
-    sf::Text weightText;
+    std::uint32_t cachedStartVersion = 0;
+    std::uint32_t cachedEndVersion = 0;
+    bool geometryBuilt = false;
+    std::uint32_t revision = 0;
+    std::array<sf::Vertex, VERTEX_COUNT> vertices;
+    std::vector<sf::Vertex> labelVertices;
+    sf::Vector2f labelPosition;
     inline static sf::Font font;
     inline static bool fontLoaded = false;
     const float LINE_THICKNESS = 3.0f;
@@ -112,7 +117,17 @@ private:
 
         std::stringstream ss;
         ss << std::fixed << std::setprecision(1) << weight.value();
-        weightText.setString(ss.str());
+
+        labelVertices.clear();
+        sf::FloatRect bounds = GlyphLayout::appendString(labelVertices, font, ss.str(), LABEL_CHARACTER_SIZE,
+                                                         false, sf::Color::White, 1.0f, sf::Color::Black);
+        GlyphLayout::translate(labelVertices, 0, sf::Vector2f(-bounds.width / 2.f, -bounds.height / 2.f));
+        ++revision;
+        updateWeightTextPosition();
+    }
+
+    void updateWeightTextPosition() {
+        if (!weight.has_value() || !fontLoaded) return;
 
         sf::Vector2f start = startNode->getPosition();
         sf::Vector2f end = endNode->getPosition();
@@ -125,12 +140,7 @@ private:
             normal = normal / length * 20.f;
         }
 
-        sf::FloatRect bounds = weightText.getLocalBounds();
-        weightText.setOrigin(bounds.width / 2.f, bounds.height / 2.f);
-        weightText.setPosition(mid + normal);
-
-        weightText.setOutlineThickness(1.0f);
-        weightText.setOutlineColor(sf::Color::Black);
+        labelPosition = mid + normal;
     }
 
     void updateVertices() {
@@ -152,40 +162,45 @@ private:
             sf::Color(Theme::EDGE_HIGHLIGHT.r, Theme::EDGE_HIGHLIGHT.g, Theme::EDGE_HIGHLIGHT.b, 100) :
             sf::Color(Theme::EDGE_COLOR.r, Theme::EDGE_COLOR.g, Theme::EDGE_COLOR.b, 40);
 
-        updateQuad(line, adjustedStart, adjustedEnd, normal, LINE_THICKNESS, edgeColor);
-        updateQuad(glow, adjustedStart, adjustedEnd, normal, GLOW_THICKNESS, glowColor);
+        updateQuad(GLOW_OFFSET, adjustedStart, adjustedEnd, normal, GLOW_THICKNESS, glowColor);
+        updateQuad(LINE_OFFSET, adjustedStart, adjustedEnd, normal, LINE_THICKNESS, edgeColor);
 
         if (showArrow) {
             updateArrowHead(adjustedEnd, -normalizedDir, edgeColor);
+        } else {
+            // Collapse the arrow so the block can still be drawn as a whole
+            for (size_t i = ARROW_OFFSET; i < VERTEX_COUNT; ++i) {
+                vertices[i].position = adjustedEnd;
+                vertices[i].color = sf::Color::Transparent;
+            }
         }
+        ++revision;
     }
 
-    void updateQuad(sf::VertexArray& vertices, const sf::Vector2f& start,
+    // Writes a quad as two triangles starting at vertices[offset].
+    void updateQuad(size_t offset, const sf::Vector2f& start,
                    const sf::Vector2f& end, const sf::Vector2f& normal,
                    float thickness, const sf::Color& color) {
-        sf::Vector2f offset = normal * (thickness / 2.f);
-
-        vertices[0].position = start - offset;
-        vertices[1].position = end - offset;
-        vertices[2].position = end + offset;
-        vertices[3].position = start + offset;
+        sf::Vector2f half = normal * (thickness / 2.f);
+        sf::Vector2f corners[4] = {start - half, end - half, end + half, start + half};
+        const int order[6] = {0, 1, 2, 0, 2, 3};
 
-        vertices[0].color = color;
-        vertices[1].color = color;
-        vertices[2].color = color;
-        vertices[3].color = color;
+        for (int i = 0; i < 6; ++i) {
+            vertices[offset + i].position = corners[order[i]];
+            vertices[offset + i].color = color;
+        }
     }
 
     void updateArrowHead(const sf::Vector2f& tip, const sf::Vector2f& dir, const sf::Color& color) {
         sf::Vector2f normal(-dir.y, dir.x);
         float arrowSize = Theme::NODE_RADIUS * 0.8f;
 
-        arrowHead[0].position = tip;
-        arrowHead[1].position = tip + (dir + normal * 0.5f) * arrowSize;
-        arrowHead[2].position = tip + (dir - normal * 0.5f) * arrowSize;
+        vertices[ARROW_OFFSET].position = tip;
+        vertices[ARROW_OFFSET + 1].position = tip + (dir + normal * 0.5f) * arrowSize;
+        vertices[ARROW_OFFSET + 2].position = tip + (dir - normal * 0.5f) * arrowSize;
 
-        arrowHead[0].color = color;
-        arrowHead[1].color = color;
-        arrowHead[2].color = color;
+        vertices[ARROW_OFFSET].color = color;
+        vertices[ARROW_OFFSET + 1].color = color;
+        vertices[ARROW_OFFSET + 2].color = color;
     }
 };
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include "Edge.hpp"
+
+// Draws every edge with at most two calls: one for the glow/line/arrow
+// triangles and one for the weight labels. Edge i owns the fixed slot
+// [i * Edge::VERTEX_COUNT, (i + 1) * Edge::VERTEX_COUNT) of the geometry, and
+// only slots whose edge revision changed are copied and re-uploaded.
+class EdgeBatchRenderer {
+public:
+    EdgeBatchRenderer() : geometryBuffer(sf::Triangles, sf::VertexBuffer::Stream) {}
+
+    void sync(const std::vector<std::unique_ptr<Edge>>& edges) {
+        const size_t vertexCount = edges.size() * Edge::VERTEX_COUNT;
+        const bool resized = geometry.size() != vertexCount;
+        if (resized) {
+            geometry.resize(vertexCount);
+            slotEdges.assign(edges.size(), nullptr);
+            slotRevisions.assign(edges.size(), 0);
+        }
+
+        size_t dirtyBegin = std::numeric_limits<size_t>::max();
+        size_t dirtyEnd = 0;
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const Edge* edge = edges[i].get();
+            if (slotEdges[i] == edge && slotRevisions[i] == edge->getRevision()) continue;
+
+            std::copy(edge->getVertices().begin(), edge->getVertices().end(),
+                      geometry.begin() + i * Edge::VERTEX_COUNT);
+            slotEdges[i] = edge;
+            slotRevisions[i] = edge->getRevision();
+            dirtyBegin = std::min(dirtyBegin, i * Edge::VERTEX_COUNT);
+            dirtyEnd = (i + 1) * Edge::VERTEX_COUNT;
+        }
+
+        const bool dirty = resized || dirtyEnd > 0;
+        if (dirty) {
+            uploadGeometry(resized, dirtyBegin, dirtyEnd);
+            rebuildLabels(edges);
+        }
+    }
+
+    void draw(sf::RenderTarget& target) {
+        drawCalls = 0;
+
+        if (!geometry.empty()) {
+            if (bufferReady) {
+                target.draw(geometryBuffer);
+            } else {
+                target.draw(geometry.data(), geometry.size(), sf::Triangles);
+            }
+            ++drawCalls;
+        }
+
+        if (!labels.empty()) {
+            sf::RenderStates states;
+            states.texture = &Edge::getLabelTexture();
+            target.draw(labels.data(), labels.size(), sf::Triangles, states);
+            ++drawCalls;
+        }
+    }
+
+    // Number of target.draw calls issued by the last draw().
+    size_t getDrawCallCount() const { return drawCalls; }
+
+private:
+    std::vector<sf::Vertex> geometry;
+    std::vector<sf::Vertex> labels;
+    std::vector<const Edge*> slotEdges;
+    std::vector<std::uint32_t> slotRevisions;
+    sf::VertexBuffer geometryBuffer;
+    bool bufferReady = false;
+    size_t drawCalls = 0;
+
+    // Falls back to drawing the client-side array when vertex buffers are
+    // unavailable on this driver.
+    void uploadGeometry(bool resized, size_t dirtyBegin, size_t dirtyEnd) {
+        if (!sf::VertexBuffer::isAvailable()) {
+            bufferReady = false;
+            return;
+        }
+
+        if (resized || !bufferReady) {
+            bufferReady = !geometry.empty() &&
+                          geometryBuffer.create(geometry.size()) &&
+                          geometryBuffer.update(geometry.data());
+            return;
+        }
+
+        bufferReady = geometryBuffer.update(geometry.data() + dirtyBegin, dirtyEnd - dirtyBegin,
+                                            static_cast<unsigned int>(dirtyBegin));
+    }
+
+    // Labels have a variable glyph count, so they are repacked as a whole
+    // whenever any edge changed; the vector keeps its capacity between frames.
+    void rebuildLabels(const std::vector<std::unique_ptr<Edge>>& edges) {
+        labels.clear();
+        for (const auto& edge : edges) {
+            const std::vector<sf::Vertex>& glyphs = edge->getLabelVertices();
+            if (glyphs.empty()) continue;
+
+            size_t first = labels.size();
+            labels.insert(labels.end(), glyphs.begin(), glyphs.end());
+            GlyphLayout::translate(labels, first, edge->getLabelPosition());
+        }
+    }
+};
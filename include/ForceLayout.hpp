@@ -0,0 +1,250 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include "ThreadPool.hpp"
+#include "NodeLayoutStore.hpp"
+#include "LayoutKernels.hpp"
+
+// Force-directed layout over a NodeLayoutStore. Repulsion is cut off at twice
+// the node radius, so only nodes in neighbouring grid cells can interact.
+//
+// Nodes are copied into cell order so every grid column is a contiguous run
+// of floats for the SIMD kernels. Each node gathers its own repulsion, and spring
+// forces go into one buffer per range that is summed in range order, so a
+// given thread count always produces bit-identical positions.
+class ForceLayout {
+public:
+    struct Springs {
+        std::vector<int> starts;
+        std::vector<int> ends;
+        std::vector<float> lengthScales;
+
+        size_t size() const { return starts.size(); }
+
+        void add(int start, int end, float lengthScale) {
+            starts.push_back(start);
+            ends.push_back(end);
+            lengthScales.push_back(lengthScale);
+        }
+
+        void reserve(size_t count) {
+            starts.reserve(count);
+            ends.reserve(count);
+            lengthScales.reserve(count);
+        }
+
+        void clear() {
+            starts.clear();
+            ends.clear();
+            lengthScales.clear();
+        }
+    };
+
+    struct Params {
+        float nodeRadius;
+        float baseRepulsion;
+        float springConstant;
+        float idealLength;
+        float damping;
+        float deltaTime;
+    };
+
+    // Declares the layout settled once the largest per-step displacement has
+    // stayed below a threshold for a run of consecutive steps.
+    struct Convergence {
+        float threshold = 0.05f;
+        int requiredQuietSteps = 30;
+        int quietSteps = 0;
+        bool asleep = false;
+
+        void record(float maxDisplacement) {
+            quietSteps = maxDisplacement < threshold ? quietSteps + 1 : 0;
+            asleep = quietSteps >= requiredQuietSteps;
+        }
+
+        void wake() {
+            quietSteps = 0;
+            asleep = false;
+        }
+    };
+
+    void setThreadPool(ThreadPool* threadPool) {
+        pool = threadPool;
+    }
+
+    // Advances one step and returns the largest distance any node moved.
+    float step(NodeLayoutStore& store, const Springs& springs, const Params& params) {
+        const size_t nodeCount = store.size();
+        if (nodeCount == 0) return 0.0f;
+
+        buildGrid(store, params.nodeRadius * 2.0f);
+
+        const bool parallel = pool && pool->getThreadCount() > 1 && nodeCount >= PARALLEL_THRESHOLD;
+        const size_t ranges = parallel ? pool->getThreadCount() : 1;
+        rangeFx.resize(ranges);
+        rangeFy.resize(ranges);
+        springFx.resize(springs.size());
+        springFy.resize(springs.size());
+
+        auto accumulate = [&](size_t range) {
+            const size_t cellCount = cellKeys.size();
+            accumulateRepulsion(store, params, cellCount * range / ranges, cellCount * (range + 1) / ranges);
+            accumulateSprings(store, springs, params, springs.size() * range / ranges,
+                              springs.size() * (range + 1) / ranges, rangeFx[range], rangeFy[range]);
+        };
+
+        rangeMotion.assign(ranges, 0.0f);
+        auto integrateRange = [&](size_t begin, size_t end, size_t range) {
+            for (size_t i = begin; i < end; ++i) {
+                for (size_t r = 0; r < ranges; ++r) {
+                    store.fx[i] += rangeFx[r][i];
+                    store.fy[i] += rangeFy[r][i];
+                }
+            }
+            rangeMotion[range] = integrate(store, params, begin, end);
+        };
+
+        if (parallel) {
+            pool->run(ranges, accumulate);
+            pool->parallelFor(nodeCount, integrateRange);
+        } else {
+            accumulate(0);
+            integrateRange(0, nodeCount, 0);
+        }
+
+        return std::sqrt(*std::max_element(rangeMotion.begin(), rangeMotion.end())) * params.deltaTime;
+    }
+
+private:
+    using CellKey = std::int64_t;
+
+    static constexpr size_t PARALLEL_THRESHOLD = 2048;
+
+    ThreadPool* pool = nullptr;
+    std::vector<std::pair<CellKey, int>> cellEntries;
+    std::vector<CellKey> cellKeys;
+    std::vector<int> cellStarts;
+    std::vector<float> sortedX;
+    std::vector<float> sortedY;
+    std::vector<float> springFx;
+    std::vector<float> springFy;
+    std::vector<std::vector<float>> rangeFx;
+    std::vector<std::vector<float>> rangeFy;
+    std::vector<float> rangeMotion;
+    float cellSize = 1.0f;
+
+    // Rows are biased so keys of vertically adjacent cells are consecutive,
+    // which turns each 3-cell column of the neighbourhood into one range.
+    static CellKey makeKey(std::int32_t cx, std::int32_t cy) {
+        return (static_cast<CellKey>(cx) << 32) |
+               (static_cast<std::uint32_t>(cy) ^ 0x80000000u);
+    }
+
+    std::int32_t cellCoord(float value) const {
+        return static_cast<std::int32_t>(std::floor(value / cellSize));
+    }
+
+    void buildGrid(const NodeLayoutStore& store, float size) {
+        cellSize = size;
+        cellEntries.resize(store.size());
+        for (size_t i = 0; i < store.size(); ++i) {
+            cellEntries[i] = {makeKey(cellCoord(store.x[i]), cellCoord(store.y[i])), static_cast<int>(i)};
+        }
+        std::sort(cellEntries.begin(), cellEntries.end());
+
+        sortedX.resize(store.size());
+        sortedY.resize(store.size());
+        cellKeys.clear();
+        cellStarts.clear();
+        for (size_t k = 0; k < cellEntries.size(); ++k) {
+            sortedX[k] = store.x[cellEntries[k].second];
+            sortedY[k] = store.y[cellEntries[k].second];
+            if (cellKeys.empty() || cellKeys.back() != cellEntries[k].first) {
+                cellKeys.push_back(cellEntries[k].first);
+                cellStarts.push_back(static_cast<int>(k));
+            }
+        }
+        cellStarts.push_back(static_cast<int>(cellEntries.size()));
+    }
+
+    // Walks whole cells in sorted order; each node only writes its own force
+    // slot, so any partition of the cells gives the same result.
+    void accumulateRepulsion(NodeLayoutStore& store, const Params& params,
+                             size_t firstCell, size_t lastCell) const {
+        for (size_t cell = firstCell; cell < lastCell; ++cell) {
+            const int first = cellStarts[cell];
+            const std::int32_t cx = cellCoord(sortedX[first]);
+            const std::int32_t cy = cellCoord(sortedY[first]);
+
+            std::pair<int, int> columns[3];
+            for (std::int32_t dx = -1; dx <= 1; ++dx) {
+                auto lo = std::lower_bound(cellKeys.begin(), cellKeys.end(), makeKey(cx + dx, cy - 1));
+                auto hi = std::upper_bound(lo, cellKeys.end(), makeKey(cx + dx, cy + 1));
+                columns[dx + 1] = {cellStarts[lo - cellKeys.begin()], cellStarts[hi - cellKeys.begin()]};
+            }
+
+            for (int k = first; k < cellStarts[cell + 1]; ++k) {
+                float fx = 0.0f;
+                float fy = 0.0f;
+                for (const auto& column : columns) {
+                    LayoutKernels::accumulateRepulsion(sortedX[k], sortedY[k],
+                                                       sortedX.data() + column.first, sortedY.data() + column.first,
+                                                       static_cast<size_t>(column.second - column.first),
+                                                       params.nodeRadius, params.baseRepulsion, fx, fy);
+                }
+
+                const int i = cellEntries[k].second;
+                store.fx[i] = fx;
+                store.fy[i] = fy;
+            }
+        }
+    }
+
+    void accumulateSprings(const NodeLayoutStore& store, const Springs& springs, const Params& params,
+                           size_t begin, size_t end, std::vector<float>& outFx, std::vector<float>& outFy) {
+        outFx.assign(store.size(), 0.0f);
+        outFy.assign(store.size(), 0.0f);
+        if (begin == end) return;
+
+        LayoutKernels::computeSprings(store.x.data(), store.y.data(), springs.starts.data(), springs.ends.data(),
+                                      springs.lengthScales.data(), begin, end, params.idealLength,
+                                      params.springConstant * params.deltaTime,
+                                      springFx.data(), springFy.data());
+
+        for (size_t s = begin; s < end; ++s) {
+            outFx[springs.starts[s]] += springFx[s];
+            outFy[springs.starts[s]] += springFy[s];
+            outFx[springs.ends[s]] -= springFx[s];
+            outFy[springs.ends[s]] -= springFy[s];
+        }
+    }
+
+    // Returns the largest squared velocity in the range.
+    float integrate(NodeLayoutStore& store, const Params& params, size_t begin, size_t end) const {
+        const float maxForce = params.nodeRadius * 5.0f;
+        float maxSpeedSquared = 0.0f;
+
+        for (size_t i = begin; i < end; ++i) {
+            float fx = store.fx[i];
+            float fy = store.fy[i];
+            float forceMagnitude = std::sqrt(fx * fx + fy * fy);
+
+            if (forceMagnitude > maxForce) {
+                fx *= maxForce / forceMagnitude;
+                fy *= maxForce / forceMagnitude;
+            }
+
+            store.vx[i] = fx * params.damping;
+            store.vy[i] = fy * params.damping;
+            store.x[i] += store.vx[i] * params.deltaTime;
+            store.y[i] += store.vy[i] * params.deltaTime;
+            if (store.vx[i] != 0.0f || store.vy[i] != 0.0f) {
+                ++store.versions[i];
+            }
+            maxSpeedSquared = std::max(maxSpeedSquared, store.vx[i] * store.vx[i] + store.vy[i] * store.vy[i]);
+        }
+        return maxSpeedSquared;
+    }
+};
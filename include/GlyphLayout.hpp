@@ -0,0 +1,101 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// Lays out a single-line string the way sf::Text does, but appends the glyph
+// quads as triangles to a caller-owned vertex list so many labels can share
+// one draw call. Texture coordinates refer to font.getTexture(characterSize).
+namespace GlyphLayout {
+
+    inline void appendGlyphQuad(std::vector<sf::Vertex>& out, sf::Vector2f position,
+                                const sf::Color& color, const sf::Glyph& glyph) {
+        const float padding = 1.0f;
+
+        float left = glyph.bounds.left - padding;
+        float top = glyph.bounds.top - padding;
+        float right = glyph.bounds.left + glyph.bounds.width + padding;
+        float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+        float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+        float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+        float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+        out.emplace_back(sf::Vector2f(position.x + left, position.y + top), color, sf::Vector2f(u1, v1));
+        out.emplace_back(sf::Vector2f(position.x + right, position.y + top), color, sf::Vector2f(u2, v1));
+        out.emplace_back(sf::Vector2f(position.x + left, position.y + bottom), color, sf::Vector2f(u1, v2));
+        out.emplace_back(sf::Vector2f(position.x + left, position.y + bottom), color, sf::Vector2f(u1, v2));
+        out.emplace_back(sf::Vector2f(position.x + right, position.y + top), color, sf::Vector2f(u2, v1));
+        out.emplace_back(sf::Vector2f(position.x + right, position.y + bottom), color, sf::Vector2f(u2, v2));
+    }
+
+    // Appends the string with its top-left layout origin at (0, 0) and returns
+    // the same local bounds sf::Text::getLocalBounds() would report.
+    inline sf::FloatRect appendString(std::vector<sf::Vertex>& out, const sf::Font& font, const std::string& text,
+                                      unsigned int characterSize, bool bold, const sf::Color& fillColor,
+                                      float outlineThickness = 0.0f,
+                                      const sf::Color& outlineColor = sf::Color::Black) {
+        float x = 0.0f;
+        float y = static_cast<float>(characterSize);
+        float minX = static_cast<float>(characterSize);
+        float minY = static_cast<float>(characterSize);
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+        const float whitespaceWidth = font.getGlyph(L' ', characterSize, bold).advance;
+        sf::Uint32 previous = 0;
+
+        for (unsigned char c : text) {
+            sf::Uint32 current = c;
+            if (current == '\r') continue;
+
+            x += font.getKerning(previous, current, characterSize, bold);
+            previous = current;
+
+            if (current == ' ' || current == '\t') {
+                minX = std::min(minX, x);
+                minY = std::min(minY, y);
+                x += current == ' ' ? whitespaceWidth : whitespaceWidth * 4;
+                maxX = std::max(maxX, x);
+                maxY = std::max(maxY, y);
+                continue;
+            }
+
+            if (outlineThickness != 0.0f) {
+                appendGlyphQuad(out, sf::Vector2f(x, y), outlineColor,
+                                font.getGlyph(current, characterSize, bold, outlineThickness));
+            }
+
+            const sf::Glyph& glyph = font.getGlyph(current, characterSize, bold);
+            appendGlyphQuad(out, sf::Vector2f(x, y), fillColor, glyph);
+
+            minX = std::min(minX, x + glyph.bounds.left);
+            maxX = std::max(maxX, x + glyph.bounds.left + glyph.bounds.width);
+            minY = std::min(minY, y + glyph.bounds.top);
+            maxY = std::max(maxY, y + glyph.bounds.top + glyph.bounds.height);
+
+            x += glyph.advance;
+        }
+
+        if (outlineThickness != 0.0f) {
+            float outline = std::abs(std::ceil(outlineThickness));
+            minX -= outline;
+            maxX += outline;
+            minY -= outline;
+            maxY += outline;
+        }
+
+        if (maxX < minX || maxY < minY) {
+            return sf::FloatRect();
+        }
+        return sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+    }
+
+    inline void translate(std::vector<sf::Vertex>& vertices, size_t begin, sf::Vector2f offset) {
+        for (size_t i = begin; i < vertices.size(); ++i) {
+            vertices[i].position += offset;
+        }
+    }
+}
@@ -3,10 +3,18 @@
 #include <memory>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
 #include <random>
 #include <cmath>
 #include "Node.hpp"
 #include "Edge.hpp"
+#include "EdgeBatchRenderer.hpp"
+#include "NodeBatchRenderer.hpp"
+#include "AdjacencyIndex.hpp"
+#include "ForceLayout.hpp"
+#include "LayoutSimulation.hpp"
 #include "Theme.hpp"
 #include "ViewportManager.hpp"
 
@@ -21,36 +29,31 @@ public:
     }
 
     void addNode(float x, float y) {
-        int id = static_cast<int>(nodes.size());
-        nodes.push_back(std::make_unique<Node>(x, y, id));
-        nodeMap[id] = nodes.back().get();
+        addNode(x, y, static_cast<int>(nodes.size()));
     }
 
     void addNode(float x, float y, int id) {
+        size_t slot = layoutStore.add(x, y);
         nodes.push_back(std::make_unique<Node>(x, y, id));
+        nodes.back()->attachLayoutStore(&layoutStore, slot);
         nodeMap[id] = nodes.back().get();
+        markStructureChanged();
     }
 
     void addEdge(Node* start, Node* end, std::optional<float> weight = std::nullopt) {
         if (!start || !end || start == end) return;
 
-        bool forwardEdgeExists = false;
-        bool reverseEdgeExists = false;
-
-        for (const auto& edge : edges) {
-            if (edge->getStartNode() == start && edge->getEndNode() == end) {
-                forwardEdgeExists = true;
-            }
-            if (edge->getStartNode() == end && edge->getEndNode() == start) {
-                reverseEdgeExists = true;
-            }
-        }
-
-        if (forwardEdgeExists) return;
+        if (!edgeKeys.insert({start, end}).second) return;
 
         auto newEdge = std::make_unique<Edge>(start, end, isDirectedGraph, weight);
         newEdge->setShowArrow(isOrderedGraph || isDirectedGraph);
         edges.push_back(std::move(newEdge));
+        markStructureChanged();
+    }
+
+    void reserveEdges(size_t count) {
+        edges.reserve(count);
+        edgeKeys.reserve(count);
     }
 
     void addEdgeById(int startId, int endId, std::optional<float> weight = std::nullopt) {
@@ -72,6 +75,8 @@ public:
 
     void setAlgorithmMode(bool enabled) {
         algorithmModeEnabled = enabled;
+        ++topologyVersion;
+        wakeLayout();
     }
 
     bool isAlgorithmMode() const {
@@ -85,6 +90,74 @@ public:
 
     bool isDirected() const { return isDirectedGraph; }
 
+    // 1 runs the layout on the calling thread, 0 uses every hardware thread.
+    void setLayoutThreadCount(size_t count) {
+        layoutSimulation.stop();
+        if (count == 1) {
+            layoutPool.reset();
+        } else {
+            layoutPool = std::make_unique<ThreadPool>(count);
+        }
+        forceLayout.setThreadPool(layoutPool.get());
+    }
+
+    size_t getLayoutThreadCount() const {
+        return layoutPool ? layoutPool->getThreadCount() : 1;
+    }
+
+    // nullptr when the layout runs on the calling thread. Other non-visual
+    // work may share the pool; ThreadPool::run() makes callers take turns.
+    ThreadPool* getLayoutPool() const { return layoutPool.get(); }
+
+    // Runs the layout on a background thread at a fixed timestep; update()
+    // then only picks up the latest published positions.
+    void setAsyncLayout(bool enabled) {
+        asyncLayoutEnabled = enabled;
+        if (!enabled) {
+            layoutSimulation.stop();
+        }
+    }
+
+    bool isAsyncLayout() const { return asyncLayoutEnabled; }
+
+    // Moves a node under the cursor and keeps the layout from pushing it away
+    // until releaseNode() is called.
+    void dragNode(Node* node, sf::Vector2f position) {
+        if (!node) return;
+        node->setPosition(position);
+        pinnedNode = node;
+        wakeLayout();
+        if (layoutSimulation.isRunning()) {
+            layoutSimulation.pin(getNodeIndex(node), position.x, position.y);
+        }
+    }
+
+    void releaseNode() {
+        pinnedNode = nullptr;
+        layoutSimulation.unpin();
+    }
+
+    struct LayoutStats {
+        size_t stepsExecuted = 0;
+        size_t idleFrames = 0;
+        bool asleep = false;
+    };
+
+    // Counters for checking that a settled layout stops doing work: steps
+    // run so far (both modes), frames that skipped layout and edge updates,
+    // and whether the layout is currently asleep.
+    LayoutStats getLayoutStats() const {
+        LayoutStats stats = layoutStats;
+        stats.stepsExecuted += layoutSimulation.getStepCount();
+        stats.asleep = asyncLayoutEnabled ? layoutSimulation.isAsleep() : layoutConvergence.asleep;
+        return stats;
+    }
+
+    void wakeLayout() {
+        layoutConvergence.wake();
+        layoutSimulation.wake();
+    }
+
     Node* findNodeAt(sf::Vector2f worldPos) {
         if (!viewportManager) return nullptr;
 
@@ -108,25 +181,65 @@ public:
             node->update(deltaTime);
         }
 
-        for (auto& edge : edges) {
-            edge->update();
+        regeneratedEdgeCount = 0;
+        bool moved = asyncLayoutEnabled ? syncAsyncLayout() : applyForceDirectedLayout(deltaTime);
+        if (!moved) {
+            ++layoutStats.idleFrames;
+            return;
         }
 
-        applyForceDirectedLayout(deltaTime);
+        for (auto& edge : edges) {
+            if (edge->update()) {
+                ++regeneratedEdgeCount;
+            }
+        }
     }
 
+    // Number of edges whose geometry was rebuilt during the last update().
+    size_t getRegeneratedEdgeCount() const { return regeneratedEdgeCount; }
+
+    // Draw calls each batch issued during the last draw().
+    size_t getEdgeDrawCallCount() const { return edgeRenderer.getDrawCallCount(); }
+    size_t getNodeDrawCallCount() const { return nodeRenderer.getDrawCallCount(); }
+
     void draw(sf::RenderTarget& target) {
-        for (const auto& edge : edges) {
-            edge->draw(target, sf::RenderStates::Default);
-        }
+        edgeRenderer.sync(edges);
+        edgeRenderer.draw(target);
+
+        nodeRenderer.sync(nodes);
+        nodeRenderer.draw(target);
+    }
 
-        for (const auto& node : nodes) {
-            node->draw(target);
+    // Colours the nodes on the source side of a cut (by node index) apart
+    // from the rest and highlights only the given edges (indices into
+    // getEdges()).
+    void highlightCut(const std::vector<char>& sourceSide, const std::vector<int>& cutEdges) {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const bool inside = i < sourceSide.size() && sourceSide[i];
+            nodes[i]->setStateColor(inside ? Theme::NODE_COMPLETED : Theme::NODE_NEW);
+            nodes[i]->setHighlighted(false);
+        }
+        for (auto& edge : edges) {
+            edge->setHighlighted(false);
+        }
+        for (int index : cutEdges) {
+            if (index >= 0 && static_cast<size_t>(index) < edges.size()) {
+                edges[index]->setHighlighted(true);
+            }
         }
     }
 
     void deleteNode(Node* node) {
         if (!node) return;
+        if (pinnedNode == node) {
+            releaseNode();
+        }
+
+        for (const auto& edge : edges) {
+            if (edge->isConnectedTo(node)) {
+                edgeKeys.erase({edge->getStartNode(), edge->getEndNode()});
+            }
+        }
 
         edges.erase(
             std::remove_if(edges.begin(), edges.end(),
@@ -137,14 +250,19 @@ public:
             edges.end()
         );
 
-        nodes.erase(
-            std::remove_if(nodes.begin(), nodes.end(),
-                [node](const std::unique_ptr<Node>& n) {
-                    return n.get() == node;
-                }
-            ),
-            nodes.end()
+        auto nodeIt = std::find_if(nodes.begin(), nodes.end(),
+            [node](const std::unique_ptr<Node>& n) {
+                return n.get() == node;
+            }
         );
+        if (nodeIt != nodes.end()) {
+            size_t slot = static_cast<size_t>(std::distance(nodes.begin(), nodeIt));
+            nodes.erase(nodeIt);
+            layoutStore.erase(slot);
+            for (size_t i = slot; i < nodes.size(); ++i) {
+                nodes[i]->setLayoutSlot(i);
+            }
+        }
 
         for (auto it = nodeMap.begin(); it != nodeMap.end(); ) {
             if (it->second == node) {
@@ -153,6 +271,8 @@ public:
                 ++it;
             }
         }
+
+        markStructureChanged();
     }
 
     std::vector<std::unique_ptr<Node>>& getNodes() { return nodes; }
@@ -160,52 +280,139 @@ public:
     const std::vector<std::unique_ptr<Edge>>& getEdges() const { return edges; }
 
     std::vector<Node*> getNeighbors(Node* node) const {
-        std::vector<Node*> neighbors;
-        for (const auto& edge : edges) {
-            if (edge->getStartNode() == node) {
-                neighbors.push_back(edge->getEndNode());
-            } else if (!isDirectedGraph && edge->getEndNode() == node) {
-                neighbors.push_back(edge->getStartNode());
-            }
+        std::vector<Node*> neighbors = getOutgoingNeighbors(node);
+        if (!isDirectedGraph) {
+            std::vector<Node*> inNeighbors = getIncomingNeighbors(node);
+            neighbors.insert(neighbors.end(), inNeighbors.begin(), inNeighbors.end());
         }
         return neighbors;
     }
 
     std::vector<Node*> getOutgoingNeighbors(Node* node) const {
-        std::vector<Node*> outNeighbors;
-        for (const auto& edge : edges) {
-            if (edge->getStartNode() == node) {
-                outNeighbors.push_back(edge->getEndNode());
-            }
-        }
-        return outNeighbors;
+        return collectNeighbors(getForwardAdjacency(), node);
     }
 
     std::vector<Node*> getIncomingNeighbors(Node* node) const {
-        std::vector<Node*> inNeighbors;
-        for (const auto& edge : edges) {
-            if (edge->getEndNode() == node) {
-                inNeighbors.push_back(edge->getStartNode());
-            }
-        }
-        return inNeighbors;
+        return collectNeighbors(getReverseAdjacency(), node);
+    }
+
+    // CSR views over node indices; rebuilt lazily after the graph changes.
+    const AdjacencyIndex& getForwardAdjacency() const {
+        if (adjacencyDirty) rebuildAdjacency();
+        return forwardAdjacency;
+    }
+
+    const AdjacencyIndex& getReverseAdjacency() const {
+        if (adjacencyDirty) rebuildAdjacency();
+        return reverseAdjacency;
+    }
+
+    int getNodeIndex(const Node* node) const {
+        if (adjacencyDirty) rebuildAdjacency();
+        auto it = nodeIndex.find(node);
+        return it != nodeIndex.end() ? it->second : -1;
     }
 
     void clear() {
+        releaseNode();
         nodes.clear();
+        layoutStore.clear();
         edges.clear();
+        edgeKeys.clear();
         nodeMap.clear();
+        markStructureChanged();
     }
 
 private:
+    using EdgeKey = std::pair<const Node*, const Node*>;
+
+    struct EdgeKeyHash {
+        size_t operator()(const EdgeKey& key) const {
+            size_t h1 = std::hash<const Node*>()(key.first);
+            size_t h2 = std::hash<const Node*>()(key.second);
+            return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
+        }
+    };
+
     std::vector<std::unique_ptr<Node>> nodes;
     std::vector<std::unique_ptr<Edge>> edges;
+    std::unordered_set<EdgeKey, EdgeKeyHash> edgeKeys;
     std::map<int, Node*> nodeMap;
     bool isDirectedGraph;
     bool isOrderedGraph;
     bool algorithmModeEnabled;
     ViewportManager* viewportManager;
     std::mt19937 rng;
+    mutable AdjacencyIndex forwardAdjacency;
+    mutable AdjacencyIndex reverseAdjacency;
+    mutable std::unordered_map<const Node*, int> nodeIndex;
+    mutable bool adjacencyDirty = true;
+    mutable ForceLayout::Springs layoutSprings;
+    NodeLayoutStore layoutStore;
+    ForceLayout forceLayout;
+    std::unique_ptr<ThreadPool> layoutPool;
+    LayoutSimulation layoutSimulation;
+    bool asyncLayoutEnabled = false;
+    size_t topologyVersion = 0;
+    size_t simulatedTopologyVersion = 0;
+    Node* pinnedNode = nullptr;
+    ForceLayout::Convergence layoutConvergence;
+    LayoutStats layoutStats;
+    size_t regeneratedEdgeCount = 0;
+    EdgeBatchRenderer edgeRenderer;
+    NodeBatchRenderer nodeRenderer;
+
+    static constexpr float ASYNC_LAYOUT_TIMESTEP = 1.0f / 60.0f;
+
+    void markStructureChanged() {
+        adjacencyDirty = true;
+        ++topologyVersion;
+        wakeLayout();
+    }
+
+    void rebuildAdjacency() const {
+        nodeIndex.clear();
+        nodeIndex.reserve(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            nodeIndex[nodes[i].get()] = static_cast<int>(i);
+        }
+
+        std::vector<int> tails;
+        std::vector<int> heads;
+        std::vector<float> arcWeights;
+        tails.reserve(edges.size());
+        heads.reserve(edges.size());
+        arcWeights.reserve(edges.size());
+        layoutSprings.clear();
+        layoutSprings.reserve(edges.size());
+
+        for (const auto& edge : edges) {
+            int start = nodeIndex.at(edge->getStartNode());
+            int end = nodeIndex.at(edge->getEndNode());
+            tails.push_back(start);
+            heads.push_back(end);
+            arcWeights.push_back(edge->getWeight().value_or(1.0f));
+
+            float lengthScale = edge->getWeight() ? 1.0f + edge->getWeight().value() * 0.1f : 1.0f;
+            layoutSprings.add(start, end, lengthScale);
+        }
+
+        forwardAdjacency.build(nodes.size(), tails, heads, arcWeights);
+        reverseAdjacency.build(nodes.size(), heads, tails, arcWeights);
+        adjacencyDirty = false;
+    }
+
+    std::vector<Node*> collectNeighbors(const AdjacencyIndex& adjacency, Node* node) const {
+        std::vector<Node*> neighbors;
+        int index = getNodeIndex(node);
+        if (index < 0) return neighbors;
+
+        neighbors.reserve(adjacency.degree(index));
+        for (int arc = adjacency.begin(index); arc < adjacency.end(index); ++arc) {
+            neighbors.push_back(nodes[adjacency.targets[arc]].get());
+        }
+        return neighbors;
+    }
 
     void updateAllEdges() {
         for (auto& edge : edges) {
@@ -214,101 +421,59 @@ private:
         }
     }
 
-    void applyForceDirectedLayout(float deltaTime) {
-        if (nodes.empty()) return;
-
-        const float springConstant = 50.0f;
-        const float nodeRadius = nodes[0]->getRadius();
+    ForceLayout::Params makeLayoutParams(float deltaTime) const {
+        const float nodeRadius = nodes.empty() ? Theme::NODE_RADIUS : nodes[0]->getRadius();
 
-        const float baseRepulsion = algorithmModeEnabled ?
+        ForceLayout::Params params;
+        params.nodeRadius = nodeRadius;
+        params.baseRepulsion = algorithmModeEnabled ?
             (1000000.0f * (nodeRadius * 5.0f)) :
             100000.0f;
-        const float damping = 0.8f;
-
-
-        std::vector<sf::Vector2f> forces(nodes.size(), sf::Vector2f(0, 0));
+        params.springConstant = 50.0f;
+        params.idealLength = algorithmModeEnabled ? nodeRadius * 8.0f : nodeRadius * 4.0f;
+        params.damping = 0.8f;
+        params.deltaTime = deltaTime;
+        return params;
+    }
 
+    bool applyForceDirectedLayout(float deltaTime) {
+        if (nodes.empty() || layoutConvergence.asleep) return false;
+        if (adjacencyDirty) rebuildAdjacency();
 
-        for (size_t i = 0; i < nodes.size(); ++i) {
-            for (size_t j = i + 1; j < nodes.size(); ++j) {
-                sf::Vector2f pos1 = nodes[i]->getPosition();
-                sf::Vector2f pos2 = nodes[j]->getPosition();
-                sf::Vector2f delta = pos1 - pos2;
-                float distance = std::sqrt(delta.x * delta.x + delta.y * delta.y);
-
-                if (distance > 0) {
-                    float nodeRadius = nodes[i]->getRadius();
-                    float repulsionFactor;
-
-                    if (distance < nodeRadius) {
-                        repulsionFactor = 2.0f;
-                    } else if (distance < 2.0f * nodeRadius) {
-                        float t = (distance - nodeRadius) / nodeRadius;
-                        repulsionFactor = 2.0f * (1.0f - t * t);
-                    } else {
-                        repulsionFactor = 0.0f;
-                    }
-
-                    if (repulsionFactor > 0) {
-                        sf::Vector2f normalizedDelta = delta / distance;
-                        sf::Vector2f force = normalizedDelta * (baseRepulsion * repulsionFactor / (distance * distance));
-
-                        if (distance < nodeRadius) {
-                            force *= 2.0f;
-                        }
-
-                        forces[i] += force;
-                        forces[j] -= force;
-                    }
-                }
-            }
-        }
+        layoutConvergence.record(forceLayout.step(layoutStore, layoutSprings, makeLayoutParams(deltaTime)));
+        ++layoutStats.stepsExecuted;
+        return true;
+    }
 
-        for (const auto& edge : edges) {
-            Node* start = edge->getStartNode();
-            Node* end = edge->getEndNode();
-
-            auto startIt = std::find_if(nodes.begin(), nodes.end(),
-                [start](const auto& n) { return n.get() == start; });
-            auto endIt = std::find_if(nodes.begin(), nodes.end(),
-                [end](const auto& n) { return n.get() == end; });
-
-            if (startIt != nodes.end() && endIt != nodes.end()) {
-                size_t startIndex = std::distance(nodes.begin(), startIt);
-                size_t endIndex = std::distance(nodes.begin(), endIt);
-
-                sf::Vector2f pos1 = start->getPosition();
-                sf::Vector2f pos2 = end->getPosition();
-                sf::Vector2f delta = pos1 - pos2;
-                float distance = std::sqrt(delta.x * delta.x + delta.y * delta.y);
-
-                if (distance > 0) {
-                    float idealLength = algorithmModeEnabled ?
-                        nodes[0]->getRadius() * 8.0f :
-                        nodes[0]->getRadius() * 4.0f;
-
-                    if (edge->getWeight()) {
-                        idealLength *= (1.0f + edge->getWeight().value() * 0.1f);
-                    }
-
-                    sf::Vector2f force = delta * ((distance - idealLength) / distance);
-                    forces[startIndex] -= force * springConstant * deltaTime;
-                    forces[endIndex] += force * springConstant * deltaTime;
-                }
+    // Restarts the simulation from the current positions whenever the graph
+    // changed shape, otherwise copies in the newest snapshot.
+    bool syncAsyncLayout() {
+        if (!layoutSimulation.isRunning() || simulatedTopologyVersion != topologyVersion) {
+            if (adjacencyDirty) rebuildAdjacency();
+            layoutSimulation.start(layoutStore, layoutSprings, makeLayoutParams(ASYNC_LAYOUT_TIMESTEP),
+                                   layoutPool.get(), ASYNC_LAYOUT_TIMESTEP);
+            simulatedTopologyVersion = topologyVersion;
+            if (pinnedNode) {
+                sf::Vector2f position = pinnedNode->getPosition();
+                layoutSimulation.pin(getNodeIndex(pinnedNode), position.x, position.y);
             }
+            return true;
         }
 
-        for (size_t i = 0; i < nodes.size(); ++i) {
-            float maxForce = nodes[i]->getRadius() * 5.0f;
-            sf::Vector2f& force = forces[i];
-            float forceMagnitude = std::sqrt(force.x * force.x + force.y * force.y);
+        const LayoutSimulation::Snapshot* snapshot = layoutSimulation.consumeSnapshot();
+        if (!snapshot || snapshot->x.size() != layoutStore.size()) return false;
 
-            if (forceMagnitude > maxForce) {
-                force *= maxForce / forceMagnitude;
+        sf::Vector2f pinnedPosition = pinnedNode ? pinnedNode->getPosition() : sf::Vector2f();
+        for (size_t i = 0; i < layoutStore.size(); ++i) {
+            if (layoutStore.x[i] != snapshot->x[i] || layoutStore.y[i] != snapshot->y[i]) {
+                layoutStore.x[i] = snapshot->x[i];
+                layoutStore.y[i] = snapshot->y[i];
+                ++layoutStore.versions[i];
             }
-
-            sf::Vector2f newPos = nodes[i]->getPosition() + force * damping * deltaTime;
-            nodes[i]->setPosition(newPos);
         }
+        if (pinnedNode) {
+            pinnedNode->setPosition(pinnedPosition);
+        }
+        return true;
     }
 };
\ No newline at end of file
@@ -116,14 +116,17 @@ public:
 
         file << graph.getNodes().size() << "\n";
 
-        for (const auto& node : graph.getNodes()) {
-            file << node->getId();
-            for (const auto& edge : graph.getEdges()) {
-                if (edge->getStartNode() == node.get()) {
-                    file << " " << edge->getEndNode()->getId();
-                    if (edge->getWeight()) {
-                        file << ":" << edge->getWeight().value();
-                    }
+        const auto& nodes = graph.getNodes();
+        const auto& edges = graph.getEdges();
+        const AdjacencyIndex& adjacency = graph.getForwardAdjacency();
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            file << nodes[i]->getId();
+            for (int arc = adjacency.begin(i); arc < adjacency.end(i); ++arc) {
+                const auto& edge = edges[adjacency.edgeIds[arc]];
+                file << " " << edge->getEndNode()->getId();
+                if (edge->getWeight()) {
+                    file << ":" << edge->getWeight().value();
                 }
             }
             file << "\n";
@@ -0,0 +1,209 @@
+#pragma once
+#include <cstddef>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LAYOUT_KERNELS_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAYOUT_KERNELS_SSE2 1
+#endif
+
+// Inner loops of ForceLayout over contiguous float arrays. Each kernel has an
+// AVX2 or SSE2 body selected at compile time and a scalar loop for the tail
+// (or for targets without SIMD).
+namespace LayoutKernels {
+
+    inline const char* getInstructionSet() {
+#if defined(LAYOUT_KERNELS_AVX2)
+        return "AVX2";
+#elif defined(LAYOUT_KERNELS_SSE2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    // Adds the repulsion that nodes xs/ys[0, count) exert on the node at
+    // (xi, yi). Nodes at distance 0 or beyond twice the radius contribute
+    // nothing, which also skips the node itself.
+    inline void accumulateRepulsion(float xi, float yi, const float* xs, const float* ys, size_t count,
+                                    float radius, float baseRepulsion, float& outFx, float& outFy) {
+        size_t k = 0;
+        float sumX = 0.0f;
+        float sumY = 0.0f;
+
+#if defined(LAYOUT_KERNELS_AVX2)
+        const __m256 vxi = _mm256_set1_ps(xi);
+        const __m256 vyi = _mm256_set1_ps(yi);
+        const __m256 vRadius = _mm256_set1_ps(radius);
+        const __m256 vCutoff = _mm256_set1_ps(2.0f * radius);
+        const __m256 vBase = _mm256_set1_ps(baseRepulsion);
+        const __m256 vZero = _mm256_setzero_ps();
+        const __m256 vOne = _mm256_set1_ps(1.0f);
+        const __m256 vTwo = _mm256_set1_ps(2.0f);
+        const __m256 vFour = _mm256_set1_ps(4.0f);
+        __m256 accX = vZero;
+        __m256 accY = vZero;
+
+        for (; k + 8 <= count; k += 8) {
+            __m256 dx = _mm256_sub_ps(vxi, _mm256_loadu_ps(xs + k));
+            __m256 dy = _mm256_sub_ps(vyi, _mm256_loadu_ps(ys + k));
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 d = _mm256_sqrt_ps(d2);
+
+            __m256 valid = _mm256_and_ps(_mm256_cmp_ps(d, vZero, _CMP_GT_OQ),
+                                         _mm256_cmp_ps(d, vCutoff, _CMP_LT_OQ));
+            __m256 inner = _mm256_cmp_ps(d, vRadius, _CMP_LT_OQ);
+
+            __m256 t = _mm256_div_ps(_mm256_sub_ps(d, vRadius), vRadius);
+            __m256 outer = _mm256_mul_ps(vTwo, _mm256_sub_ps(vOne, _mm256_mul_ps(t, t)));
+            __m256 factor = _mm256_blendv_ps(outer, vFour, inner);
+
+            __m256 coef = _mm256_div_ps(_mm256_mul_ps(vBase, factor), _mm256_mul_ps(d2, d));
+            coef = _mm256_and_ps(coef, valid);
+
+            accX = _mm256_add_ps(accX, _mm256_mul_ps(dx, coef));
+            accY = _mm256_add_ps(accY, _mm256_mul_ps(dy, coef));
+        }
+
+        alignas(32) float laneX[8];
+        alignas(32) float laneY[8];
+        _mm256_store_ps(laneX, accX);
+        _mm256_store_ps(laneY, accY);
+        for (int lane = 0; lane < 8; ++lane) {
+            sumX += laneX[lane];
+            sumY += laneY[lane];
+        }
+#elif defined(LAYOUT_KERNELS_SSE2)
+        const __m128 vxi = _mm_set1_ps(xi);
+        const __m128 vyi = _mm_set1_ps(yi);
+        const __m128 vRadius = _mm_set1_ps(radius);
+        const __m128 vCutoff = _mm_set1_ps(2.0f * radius);
+        const __m128 vBase = _mm_set1_ps(baseRepulsion);
+        const __m128 vZero = _mm_setzero_ps();
+        const __m128 vOne = _mm_set1_ps(1.0f);
+        const __m128 vTwo = _mm_set1_ps(2.0f);
+        const __m128 vFour = _mm_set1_ps(4.0f);
+        __m128 accX = vZero;
+        __m128 accY = vZero;
+
+        for (; k + 4 <= count; k += 4) {
+            __m128 dx = _mm_sub_ps(vxi, _mm_loadu_ps(xs + k));
+            __m128 dy = _mm_sub_ps(vyi, _mm_loadu_ps(ys + k));
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 d = _mm_sqrt_ps(d2);
+
+            __m128 valid = _mm_and_ps(_mm_cmpgt_ps(d, vZero), _mm_cmplt_ps(d, vCutoff));
+            __m128 inner = _mm_cmplt_ps(d, vRadius);
+
+            __m128 t = _mm_div_ps(_mm_sub_ps(d, vRadius), vRadius);
+            __m128 outer = _mm_mul_ps(vTwo, _mm_sub_ps(vOne, _mm_mul_ps(t, t)));
+            __m128 factor = _mm_or_ps(_mm_and_ps(inner, vFour), _mm_andnot_ps(inner, outer));
+
+            __m128 coef = _mm_div_ps(_mm_mul_ps(vBase, factor), _mm_mul_ps(d2, d));
+            coef = _mm_and_ps(coef, valid);
+
+            accX = _mm_add_ps(accX, _mm_mul_ps(dx, coef));
+            accY = _mm_add_ps(accY, _mm_mul_ps(dy, coef));
+        }
+
+        alignas(16) float laneX[4];
+        alignas(16) float laneY[4];
+        _mm_store_ps(laneX, accX);
+        _mm_store_ps(laneY, accY);
+        for (int lane = 0; lane < 4; ++lane) {
+            sumX += laneX[lane];
+            sumY += laneY[lane];
+        }
+#endif
+
+        for (; k < count; ++k) {
+            float dx = xi - xs[k];
+            float dy = yi - ys[k];
+            float d2 = dx * dx + dy * dy;
+            float d = std::sqrt(d2);
+            if (d <= 0.0f || d >= 2.0f * radius) continue;
+
+            float factor;
+            if (d < radius) {
+                factor = 4.0f;
+            } else {
+                float t = (d - radius) / radius;
+                factor = 2.0f * (1.0f - t * t);
+            }
+
+            float coef = baseRepulsion * factor / (d2 * d);
+            sumX += dx * coef;
+            sumY += dy * coef;
+        }
+
+        outFx += sumX;
+        outFy += sumY;
+    }
+
+    // Writes the spring force acting on the start node of springs [begin, end)
+    // into outFx/outFy; the end node receives the opposite force.
+    inline void computeSprings(const float* x, const float* y, const int* starts, const int* ends,
+                               const float* lengthScales, size_t begin, size_t end,
+                               float idealLength, float springScale, float* outFx, float* outFy) {
+        size_t s = begin;
+
+#if defined(LAYOUT_KERNELS_AVX2)
+        const __m256 vIdeal = _mm256_set1_ps(idealLength);
+        const __m256 vScale = _mm256_set1_ps(-springScale);
+        const __m256 vZero = _mm256_setzero_ps();
+
+        for (; s + 8 <= end; s += 8) {
+            __m256i vStart = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(starts + s));
+            __m256i vEnd = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ends + s));
+
+            __m256 dx = _mm256_sub_ps(_mm256_i32gather_ps(x, vStart, 4), _mm256_i32gather_ps(x, vEnd, 4));
+            __m256 dy = _mm256_sub_ps(_mm256_i32gather_ps(y, vStart, 4), _mm256_i32gather_ps(y, vEnd, 4));
+            __m256 d = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+
+            __m256 ideal = _mm256_mul_ps(vIdeal, _mm256_loadu_ps(lengthScales + s));
+            __m256 coef = _mm256_div_ps(_mm256_sub_ps(d, ideal), d);
+            coef = _mm256_and_ps(_mm256_mul_ps(coef, vScale), _mm256_cmp_ps(d, vZero, _CMP_GT_OQ));
+
+            _mm256_storeu_ps(outFx + s, _mm256_mul_ps(dx, coef));
+            _mm256_storeu_ps(outFy + s, _mm256_mul_ps(dy, coef));
+        }
+#elif defined(LAYOUT_KERNELS_SSE2)
+        const __m128 vIdeal = _mm_set1_ps(idealLength);
+        const __m128 vScale = _mm_set1_ps(-springScale);
+        const __m128 vZero = _mm_setzero_ps();
+
+        for (; s + 4 <= end; s += 4) {
+            __m128 dx = _mm_set_ps(x[starts[s + 3]] - x[ends[s + 3]], x[starts[s + 2]] - x[ends[s + 2]],
+                                   x[starts[s + 1]] - x[ends[s + 1]], x[starts[s]] - x[ends[s]]);
+            __m128 dy = _mm_set_ps(y[starts[s + 3]] - y[ends[s + 3]], y[starts[s + 2]] - y[ends[s + 2]],
+                                   y[starts[s + 1]] - y[ends[s + 1]], y[starts[s]] - y[ends[s]]);
+            __m128 d = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+            __m128 ideal = _mm_mul_ps(vIdeal, _mm_loadu_ps(lengthScales + s));
+            __m128 coef = _mm_div_ps(_mm_sub_ps(d, ideal), d);
+            coef = _mm_and_ps(_mm_mul_ps(coef, vScale), _mm_cmpgt_ps(d, vZero));
+
+            _mm_storeu_ps(outFx + s, _mm_mul_ps(dx, coef));
+            _mm_storeu_ps(outFy + s, _mm_mul_ps(dy, coef));
+        }
+#endif
+
+        for (; s < end; ++s) {
+            float dx = x[starts[s]] - x[ends[s]];
+            float dy = y[starts[s]] - y[ends[s]];
+            float d = std::sqrt(dx * dx + dy * dy);
+            if (d <= 0.0f) {
+                outFx[s] = 0.0f;
+                outFy[s] = 0.0f;
+                continue;
+            }
+
+            float coef = -springScale * (d - idealLength * lengthScales[s]) / d;
+            outFx[s] = dx * coef;
+            outFy[s] = dy * coef;
+        }
+    }
+}
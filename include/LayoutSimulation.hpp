@@ -0,0 +1,196 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "ForceLayout.hpp"
+#include "NodeLayoutStore.hpp"
+
+// Runs ForceLayout on its own thread at a fixed timestep. Positions are
+// published through a triple buffer: the simulation fills a back buffer and
+// swaps it with the shared middle slot, and the renderer swaps the middle slot
+// into its front buffer, so neither side ever blocks on the other.
+//
+// Once the layout converges the thread parks on a condition variable until a
+// pin or a restart wakes it.
+class LayoutSimulation {
+public:
+    struct Snapshot {
+        std::vector<float> x;
+        std::vector<float> y;
+    };
+
+    ~LayoutSimulation() {
+        stop();
+    }
+
+    bool isRunning() const { return worker.joinable(); }
+    bool isAsleep() const { return sleeping.load(); }
+    size_t getStepCount() const { return stepCount.load(); }
+
+    void start(const NodeLayoutStore& initial, const ForceLayout::Springs& initialSprings,
+               const ForceLayout::Params& initialParams, ThreadPool* pool, float timestep) {
+        stop();
+
+        store = initial;
+        springs = initialSprings;
+        params = initialParams;
+        params.deltaTime = timestep;
+        layout.setThreadPool(pool);
+
+        for (Snapshot& snapshot : snapshots) {
+            snapshot.x = store.x;
+            snapshot.y = store.y;
+        }
+        backIndex = 0;
+        frontIndex = 1;
+        middle.store(2);
+        pinnedSlot.store(-1);
+        convergence.wake();
+        wakeRequested = false;
+
+        running.store(true);
+        worker = std::thread([this]() { run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            running.store(false);
+        }
+        sleepCondition.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // Returns the newest published positions, or nullptr if nothing new has
+    // been published since the last call. Only call from the consuming thread.
+    const Snapshot* consumeSnapshot() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return nullptr;
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return &snapshots[frontIndex];
+    }
+
+    void pin(int slot, float x, float y) {
+        pinnedPosition.store(packPosition(x, y), std::memory_order_relaxed);
+        pinnedSlot.store(slot, std::memory_order_release);
+        wake();
+    }
+
+    void wake() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wakeRequested = true;
+        }
+        sleepCondition.notify_all();
+    }
+
+    void unpin() {
+        pinnedSlot.store(-1, std::memory_order_release);
+    }
+
+private:
+    static constexpr unsigned FRESH = 4;
+    static constexpr unsigned INDEX_MASK = 3;
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<unsigned> middle{2};
+    std::atomic<int> pinnedSlot{-1};
+    std::atomic<std::uint64_t> pinnedPosition{0};
+    std::atomic<bool> sleeping{false};
+    std::atomic<size_t> stepCount{0};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool wakeRequested = false;
+    Snapshot snapshots[3];
+    unsigned backIndex = 0;
+    unsigned frontIndex = 1;
+
+    NodeLayoutStore store;
+    ForceLayout::Springs springs;
+    ForceLayout::Params params{};
+    ForceLayout layout;
+    ForceLayout::Convergence convergence;
+
+    static std::uint64_t packPosition(float x, float y) {
+        std::uint32_t bitsX;
+        std::uint32_t bitsY;
+        std::memcpy(&bitsX, &x, sizeof(float));
+        std::memcpy(&bitsY, &y, sizeof(float));
+        return (static_cast<std::uint64_t>(bitsX) << 32) | bitsY;
+    }
+
+    static void unpackPosition(std::uint64_t packed, float& x, float& y) {
+        std::uint32_t bitsX = static_cast<std::uint32_t>(packed >> 32);
+        std::uint32_t bitsY = static_cast<std::uint32_t>(packed);
+        std::memcpy(&x, &bitsX, sizeof(float));
+        std::memcpy(&y, &bitsY, sizeof(float));
+    }
+
+    void applyPin() {
+        int slot = pinnedSlot.load(std::memory_order_acquire);
+        if (slot < 0 || static_cast<size_t>(slot) >= store.size()) return;
+        unpackPosition(pinnedPosition.load(std::memory_order_relaxed), store.x[slot], store.y[slot]);
+        store.vx[slot] = 0.0f;
+        store.vy[slot] = 0.0f;
+    }
+
+    void publish() {
+        Snapshot& back = snapshots[backIndex];
+        back.x.assign(store.x.begin(), store.x.end());
+        back.y.assign(store.y.begin(), store.y.end());
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        const auto tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(params.deltaTime));
+        auto nextTick = Clock::now();
+
+        while (running.load()) {
+            // A wake that arrives while the layout is still running only
+            // restarts the convergence window here; leaving it set would let
+            // the next sleep return at once and run a whole extra window.
+            bool woken = false;
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                std::swap(woken, wakeRequested);
+            }
+            if (woken) convergence.wake();
+
+            applyPin();
+            convergence.record(layout.step(store, springs, params));
+            applyPin();
+            publish();
+            stepCount.fetch_add(1);
+
+            if (convergence.asleep) {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleeping.store(true);
+                sleepCondition.wait(lock, [this]() { return wakeRequested || !running.load(); });
+                sleeping.store(false);
+                wakeRequested = false;
+                lock.unlock();
+
+                convergence.wake();
+                nextTick = Clock::now();
+                continue;
+            }
+
+            nextTick += tick;
+            auto now = Clock::now();
+            if (nextTick < now) {
+                nextTick = now;
+            } else {
+                std::this_thread::sleep_until(nextTick);
+            }
+        }
+    }
+};
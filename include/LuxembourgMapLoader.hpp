@@ -7,6 +7,7 @@
 #include <memory>
 #include <filesystem>
 #include <iostream>
+#include <cmath>
 #include "Graph.hpp"
 #include "tinyxml2.h"
 
@@ -57,6 +58,18 @@ private:
         return sf::Vector2f(x, y);
     }
 
+    // Some exports of this map store degrees as fixed-point integers. Returns
+    // the power of ten that brings every coordinate back into degree range.
+    static double findDegreeDivisor(const std::vector<MapNode>& nodes) {
+        double divisor = 1.0;
+        for (const auto& node : nodes) {
+            while (std::abs(node.latitude / divisor) > 90.0 || std::abs(node.longitude / divisor) > 180.0) {
+                divisor *= 10.0;
+            }
+        }
+        return divisor;
+    }
+
 public:
     static void loadFromXML(Graph& graph, const std::string& filename, sf::Vector2u windowSize) {
 
@@ -127,6 +140,7 @@ public:
         graph.clear();
 
 
+        const double degreeDivisor = findDegreeDivisor(nodes);
         std::map<int, Node*> nodeMap;
         for (const auto& node : nodes) {
             sf::Vector2f pos = convertToScreenCoordinates(
@@ -136,12 +150,17 @@ public:
             );
             graph.addNode(pos.x, pos.y, node.id);
             nodeMap[node.id] = graph.getNodes().back().get();
+            nodeMap[node.id]->setGeoCoordinates(
+                Coordinates(node.latitude / degreeDivisor, node.longitude / degreeDivisor));
         }
 
 
+        graph.reserveEdges(arcs.size());
         for (const auto& arc : arcs) {
-            if (nodeMap.count(arc.from) && nodeMap.count(arc.to)) {
-                graph.addEdge(nodeMap[arc.from], nodeMap[arc.to],
+            auto fromIt = nodeMap.find(arc.from);
+            auto toIt = nodeMap.find(arc.to);
+            if (fromIt != nodeMap.end() && toIt != nodeMap.end()) {
+                graph.addEdge(fromIt->second, toIt->second,
                             static_cast<float>(arc.length));
             }
         }
@@ -1,6 +1,7 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <string>
+#include <vector>
 
 namespace MSTColors {
     const sf::Color UNVISITED(150, 150, 255);    // Light blue
@@ -11,13 +12,20 @@ namespace MSTColors {
     const sf::Color CONSIDERING(255, 255, 100);   // Yellow
 }
 
+// Plain data so edge lists sort and queue without allocating; text for the
+// step log is built on demand by MSTVisualization::describeEdge().
 struct WeightedEdge {
     int src;
     int dest;
     float weight;
-    std::string description;
+    int id;
 
     bool operator>(const WeightedEdge& other) const {
         return weight > other.weight;
     }
-};
\ No newline at end of file
+};
+
+struct MSTResult {
+    std::vector<WeightedEdge> edges;
+    double totalWeight = 0;
+};
@@ -31,6 +31,11 @@ public:
         return it != nodeStates.end() ? it->second : defaultState;
     }
 
+    // With visualization off the setters below and addAlgorithmStep() do
+    // nothing, so an algorithm can run its step logic at full speed.
+    void setVisualizationEnabled(bool enabled) { visualizationEnabled = enabled; }
+    bool isVisualizing() const { return visualizationEnabled; }
+
     const std::string& getCurrentStepDescription() const {
         return currentStep < algorithmSteps.size() ?
                algorithmSteps[currentStep] : emptyDescription;
@@ -40,35 +45,43 @@ protected:
     std::map<int, NodeState> nodeStates;
     std::vector<std::string> algorithmSteps;
     size_t currentStep = 0;
+    bool visualizationEnabled = true;
 
     inline static NodeState defaultState{};
     inline static std::string emptyDescription = "";
 
     void setNodeColor(int nodeId, const sf::Color& color) {
+        if (!visualizationEnabled) return;
         nodeStates[nodeId].color = color;
     }
 
     void setNodeLabel(int nodeId, const std::string& label) {
+        if (!visualizationEnabled) return;
         nodeStates[nodeId].label = label;
     }
 
     void setNodeHighlight(int nodeId, bool highlighted) {
+        if (!visualizationEnabled) return;
         nodeStates[nodeId].isHighlighted = highlighted;
     }
 
     void setComponentLabel(int nodeId, const std::string& label) {
+        if (!visualizationEnabled) return;
         nodeStates[nodeId].componentLabel = label;
     }
 
     void setPulseEffect(int nodeId, float value) {
+        if (!visualizationEnabled) return;
         nodeStates[nodeId].pulseEffect = value;
     }
 
     void setNodeScale(int nodeId, float scale) {
+        if (!visualizationEnabled) return;
         nodeStates[nodeId].scale = scale;
     }
 
     void addAlgorithmStep(const std::string& description) {
+        if (!visualizationEnabled) return;
         std::stringstream ss;
         ss << "Step " << (currentStep + 1) << ": " << description;
         algorithmSteps.push_back(ss.str());
@@ -80,4 +93,9 @@ protected:
         ss << std::fixed << std::setprecision(1) << weight;
         return ss.str();
     }
+
+    std::string describeEdge(const WeightedEdge& edge) {
+        return std::to_string(edge.src) + " -> " + std::to_string(edge.dest) +
+               " (weight: " + formatWeight(edge.weight) + ")";
+    }
 };
\ No newline at end of file
@@ -1,14 +1,17 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <string>
+#include <vector>
 #include <memory>
+#include <cstdint>
 #include "Theme.hpp"
 #include "Animation.hpp"
+#include "NodeLayoutStore.hpp"
+#include "Coordinates.hpp"
 
 class Node {
 public:
     Node(float x, float y, int id);
-    void draw(sf::RenderTarget& target);
     bool contains(sf::Vector2f point) const;
     void setPosition(sf::Vector2f newPos);
     void setSelected(bool selected);
@@ -20,17 +23,52 @@ public:
     float getScale() const;
     sf::Color getColor() const;
     void setStateColor(const sf::Color& color);
+    void attachLayoutStore(NodeLayoutStore* store, size_t slot);
+    void setLayoutSlot(size_t slot) { layoutSlot = slot; }
+    void syncShapePosition();
 
-    sf::Vector2f getPosition() const { return shape.getPosition(); }
+    // Geometry for NodeBatchRenderer, appended as triangles in world space.
+    // getRenderRevision() changes whenever any of it would come out different.
+    // The disc and outline are always SHAPE_VERTEX_COUNT vertices; the
+    // highlight and selection glows are separate and usually empty.
+    static constexpr size_t SHAPE_VERTEX_COUNT = 270;
+    std::uint32_t getRenderRevision() const { return renderRevision; }
+    void appendShapeGeometry(std::vector<sf::Vertex>& out) const;
+    void appendGlowGeometry(std::vector<sf::Vertex>& out) const;
+    void appendLabelGeometry(std::vector<sf::Vertex>& out) const;
+    void appendStatusGeometry(std::vector<sf::Vertex>& backgrounds, std::vector<sf::Vertex>& labels) const;
+    static const sf::Texture& getLabelTexture();
+    static const sf::Texture& getStatusTexture();
+
+    std::uint32_t getPositionVersion() const {
+        return layoutStore ? layoutStore->versions[layoutSlot] : positionVersion;
+    }
+
+    sf::Vector2f getPosition() const {
+        return layoutStore ? sf::Vector2f(layoutStore->x[layoutSlot], layoutStore->y[layoutSlot])
+                           : shape.getPosition();
+    }
     int getId() const { return id; }
+
+    // Latitude/longitude in degrees, for nodes loaded from a map.
+    void setGeoCoordinates(const Coordinates& coordinates) {
+        geoCoordinates = coordinates;
+        hasGeo = true;
+    }
+    bool hasGeoCoordinates() const { return hasGeo; }
+    const Coordinates& getGeoCoordinates() const { return geoCoordinates; }
     float getRadius() const { return shape.getRadius(); }
     bool isSelected() const { return selected; }
     bool isHighlighted() const { return highlighted; }
 
 private:
+    static constexpr unsigned int LABEL_CHARACTER_SIZE = 24;
+    static constexpr unsigned int STATUS_CHARACTER_SIZE = 14;
+
     sf::CircleShape shape;
-    sf::Text label;
-    sf::Text statusLabel;
+    std::vector<sf::Vertex> labelGlyphs;
+    std::vector<sf::Vertex> statusGlyphs;
+    sf::FloatRect statusBounds;
     static sf::Font font;
     static bool fontLoaded;
     int id;
@@ -40,18 +78,23 @@ private:
     std::unique_ptr<Animation> colorAnimation;
     sf::Color currentColor;
     float currentScale;
+    NodeLayoutStore* layoutStore = nullptr;
+    size_t layoutSlot = 0;
+    std::uint32_t positionVersion = 0;
+    std::uint32_t renderRevision = 0;
+    Coordinates geoCoordinates;
+    bool hasGeo = false;
 
     void createSelectionAnimation();
     void createColorAnimation(const sf::Color& newColor);
-    void updateStatusLabelPosition();
-    void updateLabelPositions();
+    void touch() { ++renderRevision; }
 };
 
 
 inline void Node::setScale(float scale) {
     currentScale = scale;
     shape.setScale(scale, scale);
-    updateLabelPositions();
+    touch();
 }
 
 inline float Node::getScale() const {
@@ -66,22 +109,20 @@ inline void Node::setStateColor(const sf::Color& color) {
     currentColor = color;
     if (!colorAnimation) {
         shape.setFillColor(color);
+        touch();
     }
 }
 
-inline void Node::updateLabelPositions() {
-
-    sf::Vector2f nodePos = shape.getPosition();
-    sf::FloatRect labelBounds = label.getLocalBounds();
-    label.setOrigin(labelBounds.width/2, labelBounds.height/2);
-    label.setPosition(nodePos);
-    label.setScale(currentScale, currentScale);
-
+inline void Node::attachLayoutStore(NodeLayoutStore* store, size_t slot) {
+    layoutStore = store;
+    layoutSlot = slot;
+    syncShapePosition();
+}
 
-    if (!statusLabel.getString().isEmpty()) {
-        sf::FloatRect statusBounds = statusLabel.getLocalBounds();
-        statusLabel.setOrigin(statusBounds.width/2, statusBounds.height + shape.getRadius() * currentScale + 15);
-        statusLabel.setPosition(nodePos);
-        statusLabel.setScale(currentScale, currentScale);
+inline void Node::syncShapePosition() {
+    sf::Vector2f position = getPosition();
+    if (shape.getPosition() != position) {
+        shape.setPosition(position);
+        touch();
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include "Node.hpp"
+
+// Draws every node in five calls: highlight and selection glows, circles with
+// their outlines, id labels, status backgrounds and status labels. Node i
+// owns the fixed slot [i * Node::SHAPE_VERTEX_COUNT, (i + 1) *
+// Node::SHAPE_VERTEX_COUNT) of the circle geometry, and only slots whose node
+// revision changed are rewritten and re-uploaded. Glows and text are a small
+// fraction of the vertices and vary in size, so they are repacked whenever
+// any node changed; clear() keeps their capacity between frames.
+class NodeBatchRenderer {
+public:
+    NodeBatchRenderer() : shapeBuffer(sf::Triangles, sf::VertexBuffer::Stream) {}
+
+    void sync(const std::vector<std::unique_ptr<Node>>& nodes) {
+        const size_t vertexCount = nodes.size() * Node::SHAPE_VERTEX_COUNT;
+        const bool resized = shapes.size() != vertexCount;
+        if (resized) {
+            shapes.resize(vertexCount);
+            slotNodes.assign(nodes.size(), nullptr);
+            slotRevisions.assign(nodes.size(), 0);
+        }
+
+        size_t dirtyBegin = std::numeric_limits<size_t>::max();
+        size_t dirtyEnd = 0;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            Node* node = nodes[i].get();
+            node->syncShapePosition();
+            if (slotNodes[i] == node && slotRevisions[i] == node->getRenderRevision()) continue;
+
+            slotGeometry.clear();
+            node->appendShapeGeometry(slotGeometry);
+            std::copy(slotGeometry.begin(), slotGeometry.end(), shapes.begin() + i * Node::SHAPE_VERTEX_COUNT);
+            slotNodes[i] = node;
+            slotRevisions[i] = node->getRenderRevision();
+            dirtyBegin = std::min(dirtyBegin, i * Node::SHAPE_VERTEX_COUNT);
+            dirtyEnd = (i + 1) * Node::SHAPE_VERTEX_COUNT;
+        }
+
+        if (resized || dirtyEnd > 0) {
+            uploadShapes(resized, dirtyBegin, dirtyEnd);
+            rebuildOverlays(nodes);
+        }
+    }
+
+    void draw(sf::RenderTarget& target) {
+        drawCalls = 0;
+        drawBatch(target, glows, nullptr);
+
+        if (!shapes.empty()) {
+            if (bufferReady) {
+                target.draw(shapeBuffer);
+            } else {
+                target.draw(shapes.data(), shapes.size(), sf::Triangles);
+            }
+            ++drawCalls;
+        }
+
+        drawBatch(target, labels, &Node::getLabelTexture());
+        drawBatch(target, statusBackgrounds, nullptr);
+        drawBatch(target, statusLabels, &Node::getStatusTexture());
+    }
+
+    // Number of target.draw calls issued by the last draw().
+    size_t getDrawCallCount() const { return drawCalls; }
+
+private:
+    std::vector<sf::Vertex> shapes;
+    std::vector<sf::Vertex> slotGeometry;
+    std::vector<sf::Vertex> glows;
+    std::vector<sf::Vertex> labels;
+    std::vector<sf::Vertex> statusBackgrounds;
+    std::vector<sf::Vertex> statusLabels;
+    std::vector<const Node*> slotNodes;
+    std::vector<std::uint32_t> slotRevisions;
+    sf::VertexBuffer shapeBuffer;
+    bool bufferReady = false;
+    size_t drawCalls = 0;
+
+    // Falls back to drawing the client-side array when vertex buffers are
+    // unavailable on this driver.
+    void uploadShapes(bool resized, size_t dirtyBegin, size_t dirtyEnd) {
+        if (!sf::VertexBuffer::isAvailable()) {
+            bufferReady = false;
+            return;
+        }
+
+        if (resized || !bufferReady) {
+            bufferReady = !shapes.empty() &&
+                          shapeBuffer.create(shapes.size()) &&
+                          shapeBuffer.update(shapes.data());
+            return;
+        }
+
+        bufferReady = shapeBuffer.update(shapes.data() + dirtyBegin, dirtyEnd - dirtyBegin,
+                                         static_cast<unsigned int>(dirtyBegin));
+    }
+
+    void rebuildOverlays(const std::vector<std::unique_ptr<Node>>& nodes) {
+        glows.clear();
+        labels.clear();
+        statusBackgrounds.clear();
+        statusLabels.clear();
+
+        for (const auto& node : nodes) {
+            node->appendGlowGeometry(glows);
+            node->appendLabelGeometry(labels);
+            node->appendStatusGeometry(statusBackgrounds, statusLabels);
+        }
+    }
+
+    void drawBatch(sf::RenderTarget& target, const std::vector<sf::Vertex>& vertices, const sf::Texture* texture) {
+        if (vertices.empty()) return;
+
+        sf::RenderStates states;
+        states.texture = texture;
+        target.draw(vertices.data(), vertices.size(), sf::Triangles, states);
+        ++drawCalls;
+    }
+};
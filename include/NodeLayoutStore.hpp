@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Contiguous per-node simulation state, one slot per entry of Graph::getNodes().
+// versions[slot] is bumped whenever the position in that slot changes.
+struct NodeLayoutStore {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> fx;
+    std::vector<float> fy;
+    std::vector<std::uint32_t> versions;
+
+    size_t size() const { return x.size(); }
+
+    size_t add(float px, float py) {
+        x.push_back(px);
+        y.push_back(py);
+        vx.push_back(0.0f);
+        vy.push_back(0.0f);
+        fx.push_back(0.0f);
+        fy.push_back(0.0f);
+        versions.push_back(0);
+        return x.size() - 1;
+    }
+
+    void erase(size_t slot) {
+        x.erase(x.begin() + slot);
+        y.erase(y.begin() + slot);
+        vx.erase(vx.begin() + slot);
+        vy.erase(vy.begin() + slot);
+        fx.erase(fx.begin() + slot);
+        fy.erase(fy.begin() + slot);
+        versions.erase(versions.begin() + slot);
+    }
+
+    void reserve(size_t count) {
+        x.reserve(count);
+        y.reserve(count);
+        vx.reserve(count);
+        vy.reserve(count);
+        fx.reserve(count);
+        fy.reserve(count);
+        versions.reserve(count);
+    }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        vx.clear();
+        vy.clear();
+        fx.clear();
+        fy.clear();
+        versions.clear();
+    }
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <algorithm>
+
+// Fixed-size worker pool. run() hands out task indices to the workers and the
+// calling thread, and returns once every task has finished. Calls from
+// different threads run one after the other; a task must not call run() on
+// its own pool.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = 0) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (size_t i = 1; i < threadCount; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getThreadCount() const { return workers.size() + 1; }
+
+    void run(size_t count, const std::function<void(size_t)>& task) {
+        if (count == 0) return;
+        if (workers.empty() || count == 1) {
+            for (size_t i = 0; i < count; ++i) {
+                task(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> turn(submitMutex);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this]() { return activeWorkers == 0; });
+            currentTask = &task;
+            taskCount = count;
+            nextTask.store(0);
+            pendingTasks.store(count);
+            ++generation;
+        }
+        wake.notify_all();
+
+        drainTasks();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return pendingTasks.load() == 0 && activeWorkers == 0; });
+        currentTask = nullptr;
+    }
+
+    // Splits [0, count) into one contiguous range per thread and calls
+    // body(begin, end, rangeIndex). Range boundaries depend only on count and
+    // the thread count, so per-range results can be reduced deterministically.
+    template <typename Body>
+    void parallelFor(size_t count, Body&& body) {
+        const size_t ranges = std::min(getThreadCount(), std::max<size_t>(count, 1));
+        run(ranges, [&](size_t rangeIndex) {
+            size_t begin = count * rangeIndex / ranges;
+            size_t end = count * (rangeIndex + 1) / ranges;
+            body(begin, end, rangeIndex);
+        });
+    }
+
+    // Sorts one chunk per thread, then merges neighbouring runs pairwise,
+    // in parallel while more than one merge is left. Inputs too small to
+    // split are sorted directly.
+    template <typename Iterator, typename Compare>
+    void parallelSort(Iterator first, Iterator last, Compare comp) {
+        const size_t count = static_cast<size_t>(last - first);
+        const size_t chunks = std::min(getThreadCount(), count / MIN_SORT_CHUNK);
+        if (chunks < 2) {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        std::vector<size_t> bounds(chunks + 1);
+        for (size_t i = 0; i <= chunks; ++i) {
+            bounds[i] = count * i / chunks;
+        }
+        run(chunks, [&](size_t chunk) {
+            std::sort(first + bounds[chunk], first + bounds[chunk + 1], comp);
+        });
+
+        for (size_t width = 1; width < chunks; width *= 2) {
+            const size_t merges = (chunks + 2 * width - 1) / (2 * width);
+            run(merges, [&](size_t merge) {
+                const size_t low = merge * 2 * width;
+                const size_t middle = std::min(low + width, chunks);
+                const size_t high = std::min(low + 2 * width, chunks);
+                if (middle < high) {
+                    std::inplace_merge(first + bounds[low], first + bounds[middle], first + bounds[high], comp);
+                }
+            });
+        }
+    }
+
+private:
+    static constexpr size_t MIN_SORT_CHUNK = 1 << 14;
+
+    std::vector<std::thread> workers;
+    std::mutex submitMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* currentTask = nullptr;
+    size_t taskCount = 0;
+    size_t generation = 0;
+    size_t activeWorkers = 0;
+    std::atomic<size_t> nextTask{0};
+    std::atomic<size_t> pendingTasks{0};
+    bool stopping = false;
+
+    void drainTasks() {
+        for (;;) {
+            size_t index = nextTask.fetch_add(1);
+            if (index >= taskCount) break;
+
+            (*currentTask)(index);
+
+            if (pendingTasks.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+
+    void workerLoop() {
+        size_t seenGeneration = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+                if (stopping) return;
+                seenGeneration = generation;
+                ++activeWorkers;
+            }
+
+            drainTasks();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --activeWorkers;
+            }
+            finished.notify_all();
+        }
+    }
+};
@@ -1,11 +1,20 @@
 #pragma once
 #include "MSTAlgorithm.hpp"
+#include "DisjointSet.hpp"
+#include "../ThreadPool.hpp"
 #include <optional>
 #include <limits>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
 
 class BoruvkaMST : public MSTAlgorithm {
 private:
     std::vector<std::optional<WeightedEdge>> cheapest;
+    std::vector<char> grewInPhase;
+    bool mergedInPhase = false;
     int remainingComponents;
     int currentPhase;
     size_t currentComponentIndex;
@@ -25,22 +34,22 @@ public:
         return "Finds MST by simultaneously growing all components using their cheapest edges";
     }
 
-    void execute(std::vector<std::unique_ptr<Node>>& nodes) override {
-        parent.resize(nodes.size());
-        rank.resize(nodes.size());
+    void initialize(size_t nodeCount) override {
+        resizeSets(nodeCount);
         mstEdges.clear();
         nodeStates.clear();
         algorithmSteps.clear();
         currentStep = 0;
 
-        for (size_t i = 0; i < nodes.size(); i++) {
+        for (size_t i = 0; i < nodeCount; i++) {
             makeSet(i);
             setNodeColor(i, MSTColors::UNVISITED);
             setComponentLabel(i, "Component " + std::to_string(i));
         }
 
-        cheapest.resize(nodes.size());
-        remainingComponents = nodes.size();
+        cheapest.resize(nodeCount);
+        grewInPhase.assign(nodeCount, 0);
+        remainingComponents = nodeCount;
         currentPhase = 1;
         currentComponentIndex = 0;
         currentStepPhase = StepPhase::INIT;
@@ -72,100 +81,244 @@ public:
         return !finished;
     }
 
+    // Non-visual run to completion. Each phase makes one parallel sweep over
+    // the arcs still joining different components: every arc offers its
+    // packed (weight, edge index) key to both components with an atomic min,
+    // so each component ends up with its cheapest outgoing edge. Keys are
+    // unique, which keeps the chosen edges acyclic; components are then
+    // merged through a concurrent union-find and the internal arcs dropped.
+    const std::vector<WeightedEdge>& computeParallel(ThreadPool* pool = nullptr) {
+        const int nodeCount = countNodes();
+
+        const size_t ranges = pool ? pool->getThreadCount() : 1;
+        components.reset(nodeCount);
+        labels.resize(nodeCount);
+        std::iota(labels.begin(), labels.end(), 0);
+        cheapestKeys.assign(nodeCount, NO_EDGE);
+        rangeEdges.resize(ranges);
+        rangeCounts.resize(ranges + 1);
+        mstEdges.clear();
+
+        arcs.clear();
+        for (size_t i = 0; i < edges.size(); ++i) {
+            if (edges[i].src != edges[i].dest) {
+                arcs.push_back({edges[i].src, edges[i].dest, orderKey(edges[i].weight, i)});
+            }
+        }
+
+        while (!arcs.empty()) {
+            forRanges(pool, arcs.size(), [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i) {
+                    offerEdge(arcs[i].from, arcs[i].key);
+                    offerEdge(arcs[i].to, arcs[i].key);
+                }
+            });
+
+            // Two components that chose the same edge would both add it, so
+            // only the one with the smaller label does
+            for (auto& chosen : rangeEdges) chosen.clear();
+            forRanges(pool, nodeCount, [&](size_t begin, size_t end, size_t range) {
+                for (size_t component = begin; component < end; ++component) {
+                    const std::uint64_t key = cheapestKeys[component];
+                    if (key == NO_EDGE) continue;
+                    const WeightedEdge& edge = edges[key & 0xFFFFFFFFu];
+                    const int from = labels[edge.src];
+                    const int other = from == static_cast<int>(component) ? labels[edge.dest] : from;
+                    if (cheapestKeys[other] == key && other < static_cast<int>(component)) continue;
+                    components.unite(static_cast<int>(component), other);
+                    rangeEdges[range].push_back(edge);
+                }
+            });
+            for (const auto& chosen : rangeEdges) {
+                mstEdges.insert(mstEdges.end(), chosen.begin(), chosen.end());
+            }
+
+            forRanges(pool, nodeCount, [&](size_t begin, size_t end, size_t) {
+                for (size_t node = begin; node < end; ++node) {
+                    labels[node] = components.find(static_cast<int>(node));
+                    cheapestKeys[node] = NO_EDGE;
+                }
+            });
+
+            // Relabel the arcs and keep those still between two components,
+            // in their original order
+            std::fill(rangeCounts.begin(), rangeCounts.end(), 0);
+            forRanges(pool, arcs.size(), [&](size_t begin, size_t end, size_t range) {
+                size_t kept = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    arcs[i].from = labels[arcs[i].from];
+                    arcs[i].to = labels[arcs[i].to];
+                    kept += arcs[i].from != arcs[i].to;
+                }
+                rangeCounts[range + 1] = kept;
+            });
+            for (size_t range = 0; range < ranges; ++range) {
+                rangeCounts[range + 1] += rangeCounts[range];
+            }
+            nextArcs.resize(rangeCounts[ranges]);
+            forRanges(pool, arcs.size(), [&](size_t begin, size_t end, size_t range) {
+                size_t out = rangeCounts[range];
+                for (size_t i = begin; i < end; ++i) {
+                    if (arcs[i].from != arcs[i].to) nextArcs[out++] = arcs[i];
+                }
+            });
+            arcs.swap(nextArcs);
+        }
+
+        finished = true;
+        return mstEdges;
+    }
+
 private:
+    struct ComponentArc {
+        int from;
+        int to;
+        std::uint64_t key;
+    };
+
+    static constexpr std::uint64_t NO_EDGE = std::numeric_limits<std::uint64_t>::max();
+
+    ConcurrentDisjointSet components;
+    std::vector<int> labels;
+    std::vector<std::uint64_t> cheapestKeys;
+    std::vector<ComponentArc> arcs;
+    std::vector<ComponentArc> nextArcs;
+    std::vector<std::vector<WeightedEdge>> rangeEdges;
+    std::vector<size_t> rangeCounts;
+
+    // Weight bits flipped so unsigned order matches float order, including
+    // negative weights, with the edge index breaking ties
+    static std::uint64_t orderKey(float weight, size_t edgeIndex) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &weight, sizeof(float));
+        bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+        return (static_cast<std::uint64_t>(bits) << 32) | static_cast<std::uint32_t>(edgeIndex);
+    }
+
+    void offerEdge(int component, std::uint64_t key) {
+        std::atomic_ref<std::uint64_t> slot(cheapestKeys[component]);
+        std::uint64_t current = slot.load(std::memory_order_relaxed);
+        while (key < current && !slot.compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+        }
+    }
+
+    template <typename Body>
+    static void forRanges(ThreadPool* pool, size_t count, Body&& body) {
+        if (pool) {
+            pool->parallelFor(count, body);
+        } else {
+            body(0, count, 0);
+        }
+    }
+
     void initializePhase() {
-        std::fill(cheapest.begin(), cheapest.end(), std::nullopt);
         for (auto& [nodeId, state] : nodeStates) {
             state.isHighlighted = false;
             setNodeColor(nodeId, MSTColors::PROCESSING);
         }
 
+        computeCheapestEdges();
         currentStepPhase = StepPhase::FINDING_EDGES;
         currentComponentIndex = 0;
 
         addAlgorithmStep("Finding cheapest edges for each component...");
     }
 
+    // One sweep over the edges fills in every component's cheapest
+    // outgoing edge for the phase; ties go to the lower edge id.
+    void computeCheapestEdges() {
+        std::fill(cheapest.begin(), cheapest.end(), std::nullopt);
+        for (const auto& edge : edges) {
+            const int set1 = sets.find(edge.src);
+            const int set2 = sets.find(edge.dest);
+            if (set1 == set2) continue;
+            for (int set : {set1, set2}) {
+                auto& best = cheapest[set];
+                if (!best || edge.weight < best->weight || (edge.weight == best->weight && edge.id < best->id)) {
+                    best = edge;
+                }
+            }
+        }
+    }
+
     void findCheapestEdges() {
-        if (currentComponentIndex >= parent.size()) {
+        while (currentComponentIndex < sets.size() &&
+               sets.find(currentComponentIndex) != static_cast<int>(currentComponentIndex)) {
+            currentComponentIndex++;
+        }
+        if (currentComponentIndex >= sets.size()) {
             currentStepPhase = StepPhase::MERGING_COMPONENTS;
             currentComponentIndex = 0;
             return;
         }
 
-        int currentSet = findSet(currentComponentIndex);
-
-
-        for (size_t i = 0; i < parent.size(); i++) {
-            if (findSet(i) == currentSet) {
-                setNodeColor(i, MSTColors::CURRENT);
-                setNodeHighlight(i, true);
-            }
-        }
-
-
-        float minWeight = std::numeric_limits<float>::max();
-        WeightedEdge* bestEdge = nullptr;
-
-        for (auto& edge : edges) {
-            int set1 = findSet(edge.src);
-            int set2 = findSet(edge.dest);
-
-            if (set1 == currentSet && set2 != currentSet) {
-                if (!bestEdge || edge.weight < minWeight) {
-                    bestEdge = &edge;
-                    minWeight = edge.weight;
-                }
-            }
+        const int currentSet = static_cast<int>(currentComponentIndex);
+        if (isVisualizing()) {
+            forEachMember(currentSet, [&](int member) {
+                setNodeColor(member, MSTColors::CURRENT);
+                setNodeHighlight(member, true);
+            });
         }
 
-        if (bestEdge) {
-            cheapest[currentSet] = *bestEdge;
-            setNodeColor(bestEdge->dest, MSTColors::CONSIDERING);
+        const auto& bestEdge = cheapest[currentSet];
+        if (bestEdge && isVisualizing()) {
+            const int other = sets.find(bestEdge->src) == currentSet ? bestEdge->dest : bestEdge->src;
+            setNodeColor(other, MSTColors::CONSIDERING);
 
             addAlgorithmStep("Found cheapest edge for component " +
-                           std::to_string(currentSet) + ": " + bestEdge->description);
+                           std::to_string(currentSet) + ": " + describeEdge(*bestEdge));
         }
 
         currentComponentIndex++;
     }
 
     void mergeComponents() {
-        bool addedEdge = false;
+        mergedInPhase = false;
 
         for (size_t i = 0; i < cheapest.size(); i++) {
             if (cheapest[i]) {
-                int set1 = findSet(cheapest[i]->src);
-                int set2 = findSet(cheapest[i]->dest);
+                int set1 = sets.find(cheapest[i]->src);
+                int set2 = sets.find(cheapest[i]->dest);
 
                 if (set1 != set2) {
                     unionSets(set1, set2);
                     mstEdges.push_back(*cheapest[i]);
                     remainingComponents--;
-                    addedEdge = true;
-
+                    mergedInPhase = true;
 
-                    int newSet = findSet(set1);
-                    for (size_t j = 0; j < parent.size(); j++) {
-                        if (findSet(j) == newSet) {
-                            setNodeColor(j, MSTColors::IN_MST);
-                            setComponentLabel(j, "Component " + std::to_string(newSet));
-                            setPulseEffect(j, 1.0f);
-                        }
+                    if (isVisualizing()) {
+                        addAlgorithmStep("Merged components " + std::to_string(set1) +
+                                       " and " + std::to_string(set2) +
+                                       " using edge " + describeEdge(*cheapest[i]));
                     }
-
-                    addAlgorithmStep("Merged components " + std::to_string(set1) +
-                                   " and " + std::to_string(set2) +
-                                   " using edge " + cheapest[i]->description);
                 }
             }
         }
 
+        if (!isVisualizing()) {
+            currentStepPhase = StepPhase::PHASE_COMPLETE;
+            return;
+        }
+
+        // Colour every component that grew this phase in one pass; doing it
+        // per merge would rescan a large component once for each piece it
+        // absorbs
+        for (size_t i = 0; i < cheapest.size(); i++) {
+            if (cheapest[i]) grewInPhase[sets.find(i)] = 1;
+        }
+        for (size_t node = 0; node < sets.size(); node++) {
+            if (grewInPhase[sets.find(node)]) {
+                setNodeColor(node, MSTColors::IN_MST);
+                setPulseEffect(node, 1.0f);
+            }
+        }
+        std::fill(grewInPhase.begin(), grewInPhase.end(), 0);
+
         currentStepPhase = StepPhase::PHASE_COMPLETE;
     }
 
     void completePhase() {
-        if (remainingComponents <= 1 || !hasUnconnectedComponents()) {
+        if (remainingComponents <= 1 || !mergedInPhase) {
             finished = true;
             addAlgorithmStep("Algorithm completed! Final MST has " +
                            std::to_string(mstEdges.size()) + " edges in " +
@@ -178,13 +331,4 @@ private:
                            " components remaining");
         }
     }
-
-    bool hasUnconnectedComponents() {
-        if (parent.empty()) return false;
-        int firstSet = findSet(0);
-        for (size_t i = 1; i < parent.size(); i++) {
-            if (findSet(i) != firstSet) return true;
-        }
-        return false;
-    }
 };
\ No newline at end of file
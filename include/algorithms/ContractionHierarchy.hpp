@@ -0,0 +1,538 @@
+#pragma once
+#include "PathFinding.hpp"
+#include "IndexedHeap.hpp"
+#include "../AdjacencyIndex.hpp"
+#include "../Graph.hpp"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+
+// Contraction Hierarchies for repeated point-to-point queries on a fixed
+// graph. build() contracts nodes one at a time in order of importance and
+// adds a shortcut u->w whenever the only shortest u->w path ran through the
+// contracted node. A query is then a bidirectional Dijkstra that only walks
+// towards more important nodes, and shortcuts are expanded back into the
+// original edges afterwards.
+class ContractionHierarchy {
+public:
+    // An original arc (edgeId >= 0) or a shortcut made of two lower arcs.
+    struct Arc {
+        int from;
+        int to;
+        float weight;
+        int edgeId;
+        int firstChild;
+        int secondChild;
+    };
+
+    // Settled-node budget per witness search; lower means faster
+    // preprocessing and a few more (harmless) shortcuts.
+    void setWitnessSettleLimit(int limit) { witnessSettleLimit = limit; }
+
+    void build(const Graph& graph) {
+        std::vector<int> ids;
+        ids.reserve(graph.getNodes().size());
+        for (const auto& node : graph.getNodes()) {
+            ids.push_back(node->getId());
+        }
+        build(SearchGraph::fromGraph(graph), ids);
+    }
+
+    // nodeIds[i] is the id reported for node index i when unpacking paths.
+    void build(const SearchGraph& graph, const std::vector<int>& nodeIds) {
+        const int nodeCount = static_cast<int>(graph.nodeCount());
+        ids = nodeIds;
+        ids.resize(nodeCount, -1);
+        arcs.clear();
+        ranks.assign(nodeCount, -1);
+
+        Contractor contractor(*this, nodeCount, witnessSettleLimit);
+        for (int u = 0; u < nodeCount; ++u) {
+            graph.forEachOutgoing(u, [&](int v, float weight, int edgeId) {
+                if (u != v) contractor.addArc({u, v, weight, edgeId, -1, -1});
+            });
+        }
+        contractor.run();
+        buildSearchIndices();
+    }
+
+    bool empty() const { return ranks.empty(); }
+    size_t nodeCount() const { return ranks.size(); }
+    size_t arcCount() const { return arcs.size(); }
+    size_t shortcutCount() const {
+        return static_cast<size_t>(std::count_if(arcs.begin(), arcs.end(),
+                                                 [](const Arc& arc) { return arc.edgeId < 0; }));
+    }
+    int getRank(int node) const { return ranks[node]; }
+    const std::vector<Arc>& getArcs() const { return arcs; }
+    // Upward arcs as used by queries; edgeIds index getArcs().
+    const AdjacencyIndex& getUpwardOut() const { return upwardOut; }
+    const AdjacencyIndex& getUpwardIn() const { return upwardIn; }
+
+    // Shortest path between node indices. nodes and edgeIds refer to the
+    // original graph, with every shortcut expanded.
+    PathResult findPath(int source, int target) {
+        PathResult result;
+        const int count = static_cast<int>(nodeCount());
+        if (source < 0 || target < 0 || source >= count || target >= count) return result;
+
+        forwardSpace.prepare(count);
+        backwardSpace.prepare(count);
+        forwardSpace.reach(source, 0.0f, -1, -1);
+        forwardSpace.heap.push(source, 0.0f);
+        backwardSpace.reach(target, 0.0f, -1, -1);
+        backwardSpace.heap.push(target, 0.0f);
+
+        float best = SearchWorkspace::INFINITE_DISTANCE;
+        int meeting = -1;
+        if (source == target) {
+            best = 0.0f;
+            meeting = source;
+        }
+
+        // Each side may only stop once its own queue head reaches the best
+        // meeting distance; the upward searches do not meet in the middle.
+        bool forwardTurn = true;
+        while (true) {
+            const bool forwardOpen = !forwardSpace.heap.empty() && forwardSpace.heap.topKey() < best;
+            const bool backwardOpen = !backwardSpace.heap.empty() && backwardSpace.heap.topKey() < best;
+            if (!forwardOpen && !backwardOpen) break;
+
+            const bool forward = forwardOpen && (forwardTurn || !backwardOpen);
+            forwardTurn = !forwardTurn;
+
+            SearchWorkspace& space = forward ? forwardSpace : backwardSpace;
+            const SearchWorkspace& other = forward ? backwardSpace : forwardSpace;
+            const AdjacencyIndex& upward = forward ? upwardOut : upwardIn;
+
+            const int node = space.heap.pop();
+            const float distance = space.getDistance(node);
+            space.settle(node);
+            ++result.settledCount;
+
+            if (other.isReached(node) && distance + other.getDistance(node) < best) {
+                best = distance + other.getDistance(node);
+                meeting = node;
+            }
+
+            for (int arc = upward.begin(node); arc < upward.end(node); ++arc) {
+                const int next = upward.targets[arc];
+                const float candidate = distance + upward.weights[arc];
+                if (candidate < space.getDistance(next)) {
+                    space.reach(next, candidate, node, upward.edgeIds[arc]);
+                    space.heap.pushOrDecrease(next, candidate);
+                }
+            }
+        }
+
+        if (meeting < 0) return result;
+
+        result.found = true;
+        result.distance = best;
+
+        std::vector<int> upArcs;
+        for (int node = meeting; forwardSpace.getParent(node) != -1; node = forwardSpace.getParent(node)) {
+            upArcs.push_back(forwardSpace.getParentEdge(node));
+        }
+        std::reverse(upArcs.begin(), upArcs.end());
+        for (int node = meeting; backwardSpace.getParent(node) != -1; node = backwardSpace.getParent(node)) {
+            upArcs.push_back(backwardSpace.getParentEdge(node));
+        }
+
+        result.nodes.push_back(source);
+        for (int arc : upArcs) {
+            unpack(arc, result);
+        }
+        return result;
+    }
+
+    // Maps node indices of a path to the ids given at build time.
+    std::vector<int> toNodeIds(const PathResult& path) const {
+        std::vector<int> result;
+        result.reserve(path.nodes.size());
+        for (int node : path.nodes) {
+            result.push_back(ids[node]);
+        }
+        return result;
+    }
+
+    // Layout: "GRCH", version, node count, arc count, ranks, node ids, arcs.
+    // Integers and floats are written in host byte order.
+    void saveToFile(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        writeValue(file, FILE_MAGIC);
+        writeValue(file, FILE_VERSION);
+        writeValue(file, static_cast<std::uint32_t>(ranks.size()));
+        writeValue(file, static_cast<std::uint32_t>(arcs.size()));
+        writeArray(file, ranks);
+        writeArray(file, ids);
+        for (const Arc& arc : arcs) {
+            writeValue(file, static_cast<std::int32_t>(arc.from));
+            writeValue(file, static_cast<std::int32_t>(arc.to));
+            writeValue(file, arc.weight);
+            writeValue(file, static_cast<std::int32_t>(arc.edgeId));
+            writeValue(file, static_cast<std::int32_t>(arc.firstChild));
+            writeValue(file, static_cast<std::int32_t>(arc.secondChild));
+        }
+
+        if (!file) {
+            throw std::runtime_error("Failed to write contraction hierarchy: " + filename);
+        }
+    }
+
+    // Throws if the file is malformed or was built for a graph of a
+    // different size; the hierarchy is left unchanged in that case.
+    void loadFromFile(const std::string& filename, size_t expectedNodeCount) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        std::uint32_t storedNodes = 0;
+        std::uint32_t storedArcs = 0;
+        readValue(file, magic);
+        readValue(file, version);
+        readValue(file, storedNodes);
+        readValue(file, storedArcs);
+        if (!file || magic != FILE_MAGIC || version != FILE_VERSION) {
+            throw std::runtime_error("Not a contraction hierarchy file: " + filename);
+        }
+        if (storedNodes != expectedNodeCount) {
+            throw std::runtime_error("Contraction hierarchy was built for a different graph: " + filename);
+        }
+        // Check the counts against the file length before allocating for them
+        const std::uint64_t expectedBytes = std::uint64_t(storedNodes) * 2 * sizeof(std::int32_t) +
+                                            std::uint64_t(storedArcs) * STORED_ARC_BYTES;
+        if (remainingBytes(file) != expectedBytes) {
+            throw std::runtime_error("Truncated contraction hierarchy file: " + filename);
+        }
+
+        std::vector<int> loadedRanks(storedNodes);
+        std::vector<int> loadedIds(storedNodes);
+        readArray(file, loadedRanks);
+        readArray(file, loadedIds);
+
+        std::vector<Arc> loadedArcs(storedArcs);
+        for (Arc& arc : loadedArcs) {
+            std::int32_t fields[5];
+            readValue(file, fields[0]);
+            readValue(file, fields[1]);
+            readValue(file, arc.weight);
+            readValue(file, fields[2]);
+            readValue(file, fields[3]);
+            readValue(file, fields[4]);
+            arc = {fields[0], fields[1], arc.weight, fields[2], fields[3], fields[4]};
+        }
+
+        if (!file) {
+            throw std::runtime_error("Truncated contraction hierarchy file: " + filename);
+        }
+        if (!isConsistent(loadedRanks, loadedArcs)) {
+            throw std::runtime_error("Corrupt contraction hierarchy file: " + filename);
+        }
+
+        ranks.swap(loadedRanks);
+        ids.swap(loadedIds);
+        arcs.swap(loadedArcs);
+        buildSearchIndices();
+    }
+
+private:
+    static constexpr std::uint32_t FILE_MAGIC = 0x48435247;  // "GRCH"
+    static constexpr std::uint32_t FILE_VERSION = 1;
+    // from, to, weight, edge id and two children, four bytes each
+    static constexpr std::uint64_t STORED_ARC_BYTES = 24;
+
+    int witnessSettleLimit = 500;
+    std::vector<Arc> arcs;
+    std::vector<int> ranks;
+    std::vector<int> ids;
+    AdjacencyIndex upwardOut;   // arcs u->v with rank[v] > rank[u], at u
+    AdjacencyIndex upwardIn;    // arcs u->v with rank[u] > rank[v], reversed, at v
+    SearchWorkspace forwardSpace;
+    SearchWorkspace backwardSpace;
+
+    // Holds the shrinking graph while nodes are contracted.
+    class Contractor {
+    public:
+        Contractor(ContractionHierarchy& owner, int nodeCount, int witnessSettleLimit)
+            : hierarchy(owner), outArcs(nodeCount), inArcs(nodeCount),
+              contracted(nodeCount, false), deletedNeighbours(nodeCount, 0), levels(nodeCount, 0),
+              settleLimit(witnessSettleLimit) {}
+
+        void addArc(const Arc& arc) {
+            int id = static_cast<int>(hierarchy.arcs.size());
+            hierarchy.arcs.push_back(arc);
+            outArcs[arc.from].push_back(id);
+            inArcs[arc.to].push_back(id);
+        }
+
+        void run() {
+            const int nodeCount = static_cast<int>(outArcs.size());
+            IndexedHeap<int> queue;
+            queue.resize(nodeCount);
+            for (int v = 0; v < nodeCount; ++v) {
+                queue.push(v, priority(v));
+            }
+
+            int nextRank = 0;
+            while (!queue.empty()) {
+                // Lazy update: re-check the head and defer it if its
+                // priority went up since it was queued.
+                int v = queue.pop();
+                int current = priority(v);
+                if (!queue.empty() && current > queue.topKey()) {
+                    queue.push(v, current);
+                    continue;
+                }
+
+                contract(v);
+                hierarchy.ranks[v] = nextRank++;
+
+                for (int neighbour : neighbours(v)) {
+                    ++deletedNeighbours[neighbour];
+                    levels[neighbour] = std::max(levels[neighbour], levels[v] + 1);
+                    int updated = priority(neighbour);
+                    if (queue.contains(neighbour)) {
+                        if (updated < queue.keyOf(neighbour)) {
+                            queue.decreaseKey(neighbour, updated);
+                        } else if (updated > queue.keyOf(neighbour)) {
+                            // IndexedHeap only lowers keys, so re-queue it
+                            removeAndPush(queue, neighbour, updated);
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        struct Shortcut {
+            int inArc;
+            int outArc;
+        };
+
+        ContractionHierarchy& hierarchy;
+        std::vector<std::vector<int>> outArcs;
+        std::vector<std::vector<int>> inArcs;
+        std::vector<bool> contracted;
+        std::vector<int> deletedNeighbours;
+        std::vector<int> levels;
+        int settleLimit;
+        SearchWorkspace witnessSpace;
+        std::vector<Shortcut> shortcuts;
+        std::vector<int> neighbourScratch;
+
+        static void removeAndPush(IndexedHeap<int>& queue, int node, int key) {
+            // Pull it to the top with a key below everything, pop, re-insert
+            queue.decreaseKey(node, std::numeric_limits<int>::min());
+            queue.pop();
+            queue.push(node, key);
+        }
+
+        const std::vector<int>& neighbours(int v) {
+            neighbourScratch.clear();
+            for (int arc : inArcs[v]) {
+                int u = hierarchy.arcs[arc].from;
+                if (!contracted[u]) neighbourScratch.push_back(u);
+            }
+            for (int arc : outArcs[v]) {
+                int w = hierarchy.arcs[arc].to;
+                if (!contracted[w]) neighbourScratch.push_back(w);
+            }
+            std::sort(neighbourScratch.begin(), neighbourScratch.end());
+            neighbourScratch.erase(std::unique(neighbourScratch.begin(), neighbourScratch.end()),
+                                   neighbourScratch.end());
+            return neighbourScratch;
+        }
+
+        int priority(int v) {
+            findShortcuts(v);
+            int removed = 0;
+            for (int arc : inArcs[v]) {
+                if (!contracted[hierarchy.arcs[arc].from]) ++removed;
+            }
+            for (int arc : outArcs[v]) {
+                if (!contracted[hierarchy.arcs[arc].to]) ++removed;
+            }
+            int edgeDifference = static_cast<int>(shortcuts.size()) - removed;
+            return 2 * edgeDifference + deletedNeighbours[v] + levels[v];
+        }
+
+        void contract(int v) {
+            findShortcuts(v);
+            for (const Shortcut& shortcut : shortcuts) {
+                const Arc& first = hierarchy.arcs[shortcut.inArc];
+                const Arc& second = hierarchy.arcs[shortcut.outArc];
+                addArc({first.from, second.to, first.weight + second.weight, -1, shortcut.inArc, shortcut.outArc});
+            }
+            contracted[v] = true;
+        }
+
+        // Collects the shortcuts contracting v would need: u->v->w pairs with
+        // no path of at most the same length that avoids v.
+        void findShortcuts(int v) {
+            shortcuts.clear();
+
+            float maxOut = 0.0f;
+            for (int arc : outArcs[v]) {
+                if (!contracted[hierarchy.arcs[arc].to]) {
+                    maxOut = std::max(maxOut, hierarchy.arcs[arc].weight);
+                }
+            }
+
+            for (int inArc : inArcs[v]) {
+                const int u = hierarchy.arcs[inArc].from;
+                if (contracted[u]) continue;
+
+                const float inWeight = hierarchy.arcs[inArc].weight;
+                witnessSearch(u, v, inWeight + maxOut);
+
+                for (int outArc : outArcs[v]) {
+                    const int w = hierarchy.arcs[outArc].to;
+                    if (contracted[w] || w == u) continue;
+
+                    const float viaWeight = inWeight + hierarchy.arcs[outArc].weight;
+                    if (witnessSpace.getDistance(w) > viaWeight) {
+                        shortcuts.push_back({inArc, outArc});
+                    }
+                }
+            }
+        }
+
+        // Bounded Dijkstra from source over uncontracted nodes, skipping the
+        // node being contracted.
+        void witnessSearch(int source, int skipped, float limit) {
+            witnessSpace.prepare(outArcs.size());
+            witnessSpace.reach(source, 0.0f, -1, -1);
+            witnessSpace.heap.push(source, 0.0f);
+
+            int settled = 0;
+            while (!witnessSpace.heap.empty() && settled < settleLimit) {
+                if (witnessSpace.heap.topKey() > limit) break;
+                const int node = witnessSpace.heap.pop();
+                const float distance = witnessSpace.getDistance(node);
+                ++settled;
+
+                for (int arc : outArcs[node]) {
+                    const int next = hierarchy.arcs[arc].to;
+                    if (next == skipped || contracted[next]) continue;
+
+                    const float candidate = distance + hierarchy.arcs[arc].weight;
+                    if (candidate < witnessSpace.getDistance(next)) {
+                        witnessSpace.reach(next, candidate, node, arc);
+                        witnessSpace.heap.pushOrDecrease(next, candidate);
+                    }
+                }
+            }
+        }
+    };
+
+    void buildSearchIndices() {
+        const size_t count = ranks.size();
+        std::vector<int> tails[2];
+        std::vector<int> heads[2];
+        std::vector<float> weights[2];
+        std::vector<int> arcIds[2];
+
+        for (size_t id = 0; id < arcs.size(); ++id) {
+            const Arc& arc = arcs[id];
+            const int side = ranks[arc.to] > ranks[arc.from] ? 0 : 1;
+            tails[side].push_back(side == 0 ? arc.from : arc.to);
+            heads[side].push_back(side == 0 ? arc.to : arc.from);
+            weights[side].push_back(arc.weight);
+            arcIds[side].push_back(static_cast<int>(id));
+        }
+
+        upwardOut.build(count, tails[0], heads[0], weights[0]);
+        upwardIn.build(count, tails[1], heads[1], weights[1]);
+        for (int& edgeId : upwardOut.edgeIds) edgeId = arcIds[0][edgeId];
+        for (int& edgeId : upwardIn.edgeIds) edgeId = arcIds[1][edgeId];
+    }
+
+    // Appends the original edges and end nodes of an arc to the path.
+    // What buildSearchIndices() and unpack() rely on: ranks are a
+    // permutation of the nodes, arcs join valid nodes with a non-negative
+    // weight, and a shortcut is made of two earlier arcs that chain from its
+    // tail to its head, so unpacking always ends.
+    static bool isConsistent(const std::vector<int>& nodeRanks, const std::vector<Arc>& hierarchyArcs) {
+        const int count = static_cast<int>(nodeRanks.size());
+        std::vector<char> rankUsed(count, 0);
+        for (int rank : nodeRanks) {
+            if (rank < 0 || rank >= count || rankUsed[rank]) return false;
+            rankUsed[rank] = 1;
+        }
+
+        for (size_t id = 0; id < hierarchyArcs.size(); ++id) {
+            const Arc& arc = hierarchyArcs[id];
+            if (arc.from < 0 || arc.from >= count || arc.to < 0 || arc.to >= count) return false;
+            if (!(arc.weight >= 0.0f)) return false;
+            if (arc.edgeId >= 0) continue;
+
+            const int limit = static_cast<int>(id);
+            if (arc.firstChild < 0 || arc.firstChild >= limit || arc.secondChild < 0 || arc.secondChild >= limit) {
+                return false;
+            }
+            const Arc& first = hierarchyArcs[arc.firstChild];
+            const Arc& second = hierarchyArcs[arc.secondChild];
+            if (first.from != arc.from || first.to != second.from || second.to != arc.to) return false;
+        }
+        return true;
+    }
+
+    void unpack(int arcId, PathResult& path) const {
+        std::vector<int> stack{arcId};
+        while (!stack.empty()) {
+            const Arc& arc = arcs[stack.back()];
+            stack.pop_back();
+            if (arc.edgeId >= 0) {
+                path.edgeIds.push_back(arc.edgeId);
+                path.nodes.push_back(arc.to);
+            } else {
+                stack.push_back(arc.secondChild);
+                stack.push_back(arc.firstChild);
+            }
+        }
+    }
+
+    template <typename T>
+    static void writeValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static void readValue(std::ifstream& file, T& value) {
+        file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    static std::uint64_t remainingBytes(std::ifstream& file) {
+        const std::streampos current = file.tellg();
+        file.seekg(0, std::ios::end);
+        const std::streampos end = file.tellg();
+        file.seekg(current);
+        return static_cast<std::uint64_t>(end - current);
+    }
+
+    static void writeArray(std::ofstream& file, const std::vector<int>& values) {
+        for (int value : values) {
+            writeValue(file, static_cast<std::int32_t>(value));
+        }
+    }
+
+    static void readArray(std::ifstream& file, std::vector<int>& values) {
+        for (int& value : values) {
+            std::int32_t stored = 0;
+            readValue(file, stored);
+            value = stored;
+        }
+    }
+};
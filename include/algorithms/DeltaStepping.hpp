@@ -0,0 +1,313 @@
+#pragma once
+#include "PathFinding.hpp"
+#include "../ThreadPool.hpp"
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+
+// Parallel single-source shortest paths (Meyer & Sanders delta-stepping).
+// Nodes are kept in buckets of width delta. The lowest bucket is emptied by
+// repeatedly relaxing its light arcs (weight <= delta) in parallel, since
+// those can refill the same bucket; heavy arcs are relaxed once afterwards.
+//
+// Each node's tentative distance and parent share one 64-bit word updated
+// with an atomic minimum, so ties go to the smaller parent index and the
+// result does not depend on the thread count.
+//
+// The bucket ring covers at most MAX_RING_SIZE buckets past the current one;
+// nodes further out wait in an overflow list until the ring reaches them, and
+// an empty ring jumps straight to the lowest overflow bucket. A few very
+// heavy arcs or a tiny delta therefore cost neither memory nor empty scans.
+class DeltaStepping {
+public:
+    explicit DeltaStepping(ThreadPool* threadPool = nullptr) : pool(threadPool) {}
+
+    void setThreadPool(ThreadPool* threadPool) { pool = threadPool; }
+
+    // 0 picks delta from the weight distribution on every compute().
+    void setDelta(float value) { requestedDelta = value; }
+    float getLastDelta() const { return delta; }
+
+    void compute(const SearchGraph& graph, int source) {
+        const size_t nodeCount = graph.nodeCount();
+        distances.assign(nodeCount, SearchWorkspace::INFINITE_DISTANCE);
+        parents.assign(nodeCount, -1);
+        if (source < 0 || static_cast<size_t>(source) >= nodeCount) return;
+
+        maxWeight = checkWeights(graph);
+        delta = requestedDelta > 0.0f ? requestedDelta : tuneDelta(graph);
+        // Keep bucket indices far below the size_t range even for a tiny delta
+        const float smallestDelta = static_cast<float>(static_cast<double>(maxWeight) * nodeCount / MAX_BUCKET_SPAN);
+        delta = std::max(delta, smallestDelta);
+        splitArcs(graph);
+
+        packed.assign(nodeCount, UNREACHED);
+        frontierStamps.assign(nodeCount, 0);
+        removedStamps.assign(nodeCount, 0);
+        stamp = 0;
+        phase = 0;
+
+        const double span = static_cast<double>(maxWeight) / delta + 2.0;
+        const size_t ringSize = span < MAX_RING_SIZE ? static_cast<size_t>(span) : MAX_RING_SIZE;
+        ring.assign(ringSize, {});
+        ringPending = 0;
+        overflow.clear();
+        currentBucket = 0;
+
+        packed[source] = pack(0.0f, source);
+        insert(source, 0);
+
+        const size_t ranges = pool ? pool->getThreadCount() : 1;
+        requests.resize(ranges);
+
+        while (ringPending > 0 || !overflow.empty()) {
+            if (ringPending == 0) {
+                currentBucket = std::max(currentBucket, overflowMin);
+            }
+            if (!overflow.empty() && overflowMin < currentBucket + ringSize) {
+                drainOverflow();
+            }
+
+            std::vector<int>& slot = ring[currentBucket % ringSize];
+            if (!slot.empty()) {
+                ++phase;
+                removed.clear();
+                while (!slot.empty()) {
+                    collectFrontier(slot, currentBucket);
+                    relax(frontier, lightOffsets, lightTargets, lightWeights);
+                }
+
+                relax(removed, heavyOffsets, heavyTargets, heavyWeights);
+            }
+            ++currentBucket;
+        }
+
+        for (size_t v = 0; v < nodeCount; ++v) {
+            if (packed[v] == UNREACHED) continue;
+            distances[v] = unpackDistance(packed[v]);
+            parents[v] = v == static_cast<size_t>(source) ? -1 : static_cast<int>(packed[v] & 0xFFFFFFFFu);
+        }
+    }
+
+    float getDistance(int node) const { return distances[node]; }
+    int getParent(int node) const { return parents[node]; }
+    const std::vector<float>& getDistances() const { return distances; }
+
+private:
+    static constexpr std::uint64_t UNREACHED = ~std::uint64_t(0);
+    // Aim for about this many light arcs per node when tuning delta.
+    static constexpr float TARGET_LIGHT_DEGREE = 2.0f;
+    static constexpr size_t MAX_RING_SIZE = 1024;
+    static constexpr double MAX_BUCKET_SPAN = 1099511627776.0;  // 2^40
+
+    struct OverflowEntry {
+        int node;
+        size_t bucket;
+    };
+
+    ThreadPool* pool;
+    float requestedDelta = 0.0f;
+    float delta = 1.0f;
+    float maxWeight = 0.0f;
+
+    std::vector<int> lightOffsets;
+    std::vector<int> lightTargets;
+    std::vector<float> lightWeights;
+    std::vector<int> heavyOffsets;
+    std::vector<int> heavyTargets;
+    std::vector<float> heavyWeights;
+
+    std::vector<std::uint64_t> packed;
+    std::vector<std::uint32_t> frontierStamps;
+    std::vector<std::uint32_t> removedStamps;
+    std::uint32_t stamp = 0;
+    std::uint32_t phase = 0;
+    std::vector<std::vector<int>> ring;
+    size_t ringPending = 0;
+    size_t currentBucket = 0;
+    std::vector<OverflowEntry> overflow;
+    size_t overflowMin = 0;
+    std::vector<int> frontier;
+    std::vector<int> removed;
+    std::vector<std::vector<int>> requests;
+
+    std::vector<float> distances;
+    std::vector<int> parents;
+
+    // Non-negative floats order the same way as their bit patterns, so the
+    // distance can sit in the high half of an integer compared as a whole.
+    static std::uint64_t pack(float distance, int parent) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &distance, sizeof(float));
+        return (static_cast<std::uint64_t>(bits) << 32) | static_cast<std::uint32_t>(parent);
+    }
+
+    static float unpackDistance(std::uint64_t value) {
+        std::uint32_t bits = static_cast<std::uint32_t>(value >> 32);
+        float distance;
+        std::memcpy(&distance, &bits, sizeof(float));
+        return distance;
+    }
+
+    size_t bucketOf(float distance) const {
+        const double index = static_cast<double>(distance) / delta;
+        return index < MAX_BUCKET_SPAN ? static_cast<size_t>(index) : static_cast<size_t>(MAX_BUCKET_SPAN);
+    }
+
+    void insert(int node, size_t bucket) {
+        if (bucket < currentBucket + ring.size()) {
+            ring[bucket % ring.size()].push_back(node);
+            ++ringPending;
+            return;
+        }
+        if (overflow.empty() || bucket < overflowMin) overflowMin = bucket;
+        overflow.push_back({node, bucket});
+    }
+
+    // Moves overflow entries that now fall inside the ring into it and drops
+    // the ones whose node has since improved to another bucket.
+    void drainOverflow() {
+        size_t kept = 0;
+        overflowMin = ~size_t(0);
+        for (const OverflowEntry& entry : overflow) {
+            if (bucketOf(unpackDistance(packed[entry.node])) != entry.bucket) continue;
+            if (entry.bucket < currentBucket + ring.size()) {
+                ring[entry.bucket % ring.size()].push_back(entry.node);
+                ++ringPending;
+            } else {
+                overflowMin = std::min(overflowMin, entry.bucket);
+                overflow[kept++] = entry;
+            }
+        }
+        overflow.resize(kept);
+    }
+
+    // Delta-stepping needs finite, non-negative weights, and pack() only
+    // orders non-negative floats correctly. Returns the largest weight.
+    static float checkWeights(const SearchGraph& graph) {
+        float largest = 0.0f;
+        for (int v = 0; v < static_cast<int>(graph.nodeCount()); ++v) {
+            graph.forEachOutgoing(v, [&](int, float weight, int) {
+                if (!(weight >= 0.0f) || std::isinf(weight)) {
+                    throw std::runtime_error("Delta-stepping needs finite, non-negative arc weights");
+                }
+                largest = std::max(largest, weight);
+            });
+        }
+        return largest;
+    }
+
+    // Chooses the weight quantile that leaves roughly TARGET_LIGHT_DEGREE
+    // light arcs per node: small enough that a bucket rarely needs many
+    // light phases, large enough that buckets are not mostly empty.
+    float tuneDelta(const SearchGraph& graph) const {
+        std::vector<float> weights;
+        for (int v = 0; v < static_cast<int>(graph.nodeCount()); ++v) {
+            graph.forEachOutgoing(v, [&](int, float weight, int) { weights.push_back(weight); });
+        }
+        if (weights.empty()) return 1.0f;
+
+        const float averageDegree = static_cast<float>(weights.size()) / graph.nodeCount();
+        const float fraction = std::min(1.0f, TARGET_LIGHT_DEGREE / averageDegree);
+        const size_t index = std::min(weights.size() - 1, static_cast<size_t>(fraction * (weights.size() - 1)));
+        std::nth_element(weights.begin(), weights.begin() + index, weights.end());
+
+        float chosen = weights[index];
+        if (chosen <= 0.0f) {
+            float largest = *std::max_element(weights.begin(), weights.end());
+            chosen = largest > 0.0f ? largest : 1.0f;
+        }
+        return chosen;
+    }
+
+    void splitArcs(const SearchGraph& graph) {
+        const int nodeCount = static_cast<int>(graph.nodeCount());
+        lightOffsets.assign(1, 0);
+        heavyOffsets.assign(1, 0);
+        lightTargets.clear();
+        lightWeights.clear();
+        heavyTargets.clear();
+        heavyWeights.clear();
+        for (int v = 0; v < nodeCount; ++v) {
+            graph.forEachOutgoing(v, [&](int target, float weight, int) {
+                if (weight <= delta) {
+                    lightTargets.push_back(target);
+                    lightWeights.push_back(weight);
+                } else {
+                    heavyTargets.push_back(target);
+                    heavyWeights.push_back(weight);
+                }
+            });
+            lightOffsets.push_back(static_cast<int>(lightTargets.size()));
+            heavyOffsets.push_back(static_cast<int>(heavyTargets.size()));
+        }
+    }
+
+    // Moves the live entries of the bucket into frontier. Entries are stale
+    // if the node has since improved into a lower bucket or is already in
+    // this frontier.
+    void collectFrontier(std::vector<int>& slot, size_t bucket) {
+        ++stamp;
+        frontier.clear();
+        for (int node : slot) {
+            --ringPending;
+            if (frontierStamps[node] == stamp) continue;
+            if (bucketOf(unpackDistance(packed[node])) != bucket) continue;
+            frontierStamps[node] = stamp;
+            frontier.push_back(node);
+        }
+        slot.clear();
+
+        // A node can return to the bucket through a light arc, but its heavy
+        // arcs only need relaxing once, after its distance is final.
+        for (int node : frontier) {
+            if (removedStamps[node] == phase) continue;
+            removedStamps[node] = phase;
+            removed.push_back(node);
+        }
+    }
+
+    void relax(const std::vector<int>& nodes, const std::vector<int>& offsets,
+               const std::vector<int>& targets, const std::vector<float>& weights) {
+        if (nodes.empty()) return;
+
+        auto body = [&](size_t begin, size_t end, size_t range) {
+            std::vector<int>& improved = requests[range];
+            for (size_t k = begin; k < end; ++k) {
+                const int node = nodes[k];
+                const float distance = unpackDistance(std::atomic_ref<std::uint64_t>(packed[node]).load());
+                for (int arc = offsets[node]; arc < offsets[node + 1]; ++arc) {
+                    const int target = targets[arc];
+                    const std::uint64_t candidate = pack(distance + weights[arc], node);
+                    std::atomic_ref<std::uint64_t> slot(packed[target]);
+                    std::uint64_t current = slot.load(std::memory_order_relaxed);
+                    while (candidate < current) {
+                        if (slot.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                            improved.push_back(target);
+                            break;
+                        }
+                    }
+                }
+            }
+        };
+
+        if (pool && nodes.size() >= PARALLEL_THRESHOLD) {
+            pool->parallelFor(nodes.size(), body);
+        } else {
+            body(0, nodes.size(), 0);
+        }
+
+        for (std::vector<int>& improved : requests) {
+            for (int node : improved) {
+                insert(node, bucketOf(unpackDistance(packed[node])));
+            }
+            improved.clear();
+        }
+    }
+
+    static constexpr size_t PARALLEL_THRESHOLD = 256;
+};
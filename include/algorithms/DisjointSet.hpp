@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+#include <numeric>
+#include <cstddef>
+#include <utility>
+#include <atomic>
+
+// Union-find over 0..count-1 with union by size and path halving, kept to
+// two flat arrays so it stays cheap on large edge lists.
+class DisjointSet {
+public:
+    explicit DisjointSet(size_t count = 0) { reset(count); }
+
+    void reset(size_t count) {
+        parents.resize(count);
+        std::iota(parents.begin(), parents.end(), 0);
+        sizes.assign(count, 1);
+        sets = count;
+    }
+
+    size_t size() const { return parents.size(); }
+    size_t setCount() const { return sets; }
+
+    int find(int node) {
+        while (parents[node] != node) {
+            parents[node] = parents[parents[node]];
+            node = parents[node];
+        }
+        return node;
+    }
+
+    // Same as find() but without writes, so several threads may call it as
+    // long as nothing unites at the same time.
+    int findRoot(int node) const {
+        while (parents[node] != node) {
+            node = parents[node];
+        }
+        return node;
+    }
+
+    int setSize(int node) { return sizes[find(node)]; }
+
+    // Returns false if a and b were already in the same set.
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (sizes[a] < sizes[b]) std::swap(a, b);
+        parents[b] = a;
+        sizes[a] += sizes[b];
+        --sets;
+        return true;
+    }
+
+private:
+    std::vector<int> parents;
+    std::vector<int> sizes;
+    size_t sets = 0;
+};
+
+// Lock-free union-find for concurrent unite() and find() calls. Roots are
+// linked by compare-and-swap, always under the smaller index so no cycle can
+// form, and find() halves paths with CAS as it walks.
+class ConcurrentDisjointSet {
+public:
+    explicit ConcurrentDisjointSet(size_t count = 0) { reset(count); }
+
+    void reset(size_t count) {
+        parents.resize(count);
+        std::iota(parents.begin(), parents.end(), 0);
+    }
+
+    size_t size() const { return parents.size(); }
+
+    int find(int node) {
+        for (;;) {
+            const int parent = link(node).load(std::memory_order_relaxed);
+            if (parent == node) return node;
+            int grandparent = link(parent).load(std::memory_order_relaxed);
+            if (grandparent != parent) {
+                int expected = parent;
+                link(node).compare_exchange_weak(expected, grandparent, std::memory_order_relaxed);
+            }
+            node = parent;
+        }
+    }
+
+    // Returns false if a and b were already in the same set.
+    bool unite(int a, int b) {
+        for (;;) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (a < b) std::swap(a, b);
+            int expected = a;
+            if (link(a).compare_exchange_strong(expected, b, std::memory_order_acq_rel)) return true;
+        }
+    }
+
+private:
+    std::vector<int> parents;
+
+    std::atomic_ref<int> link(int node) { return std::atomic_ref<int>(parents[node]); }
+};
@@ -0,0 +1,262 @@
+#pragma once
+#include "PathFinding.hpp"
+#include "ContractionHierarchy.hpp"
+#include "../ThreadPool.hpp"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+
+// Dense row-major table of distances, one row per source and one column per
+// target. Unreachable pairs hold SearchWorkspace::INFINITE_DISTANCE.
+class DistanceMatrix {
+public:
+    void resize(size_t rowCount, size_t columnCount) {
+        rows = rowCount;
+        columns = columnCount;
+        values.assign(rows * columns, SearchWorkspace::INFINITE_DISTANCE);
+    }
+
+    size_t getRowCount() const { return rows; }
+    size_t getColumnCount() const { return columns; }
+
+    float at(size_t row, size_t column) const { return values[row * columns + column]; }
+    float& at(size_t row, size_t column) { return values[row * columns + column]; }
+    float* row(size_t index) { return values.data() + index * columns; }
+    const std::vector<float>& getValues() const { return values; }
+
+    // Layout: "GRDM", version, row count, column count, then the values row
+    // by row. Integers and floats are written in host byte order.
+    void saveToFile(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        const std::uint32_t header[4] = {FILE_MAGIC, FILE_VERSION,
+                                          static_cast<std::uint32_t>(rows),
+                                          static_cast<std::uint32_t>(columns)};
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+
+        if (!file) {
+            throw std::runtime_error("Failed to write distance matrix: " + filename);
+        }
+    }
+
+    void loadFromFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        std::uint32_t header[4] = {};
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!file || header[0] != FILE_MAGIC || header[1] != FILE_VERSION) {
+            throw std::runtime_error("Not a distance matrix file: " + filename);
+        }
+
+        // The counts come from the file, so check them against its length
+        // before allocating; the product alone could overflow.
+        const std::streampos start = file.tellg();
+        file.seekg(0, std::ios::end);
+        const std::uint64_t valueCount = static_cast<std::uint64_t>(file.tellg() - start) / sizeof(float);
+        file.seekg(start);
+        const std::uint64_t storedRows = header[2];
+        const std::uint64_t storedColumns = header[3];
+        if (storedRows != 0 && storedColumns > valueCount / storedRows) {
+            throw std::runtime_error("Truncated distance matrix file: " + filename);
+        }
+
+        std::vector<float> loaded(storedRows * storedColumns);
+        file.read(reinterpret_cast<char*>(loaded.data()), loaded.size() * sizeof(float));
+        if (!file) {
+            throw std::runtime_error("Truncated distance matrix file: " + filename);
+        }
+        rows = storedRows;
+        columns = storedColumns;
+        values.swap(loaded);
+    }
+
+private:
+    static constexpr std::uint32_t FILE_MAGIC = 0x4D445247;  // "GRDM"
+    static constexpr std::uint32_t FILE_VERSION = 1;
+
+    size_t rows = 0;
+    size_t columns = 0;
+    std::vector<float> values;
+};
+
+// Fills a DistanceMatrix for sets of source and target node indices.
+//
+// With a ContractionHierarchy it uses the bucket method: one upward search
+// per target leaves (column, distance) entries at every node it settles, then
+// one upward search per source combines its own distances with the buckets
+// it meets. Each search only sees the few hundred nodes above its start, so
+// the table costs about |sources| + |targets| small searches.
+//
+// Without a hierarchy it runs one Dijkstra per source, stopping once every
+// target is settled. Either way the searches are spread over the thread pool
+// and each worker keeps its own workspace between searches.
+class ManyToManySearch {
+public:
+    explicit ManyToManySearch(ThreadPool* threadPool = nullptr) : pool(threadPool) {}
+
+    void setThreadPool(ThreadPool* threadPool) { pool = threadPool; }
+
+    void compute(const ContractionHierarchy& hierarchy, const std::vector<int>& sources,
+                 const std::vector<int>& targets, DistanceMatrix& result) {
+        result.resize(sources.size(), targets.size());
+        const int nodeCount = static_cast<int>(hierarchy.nodeCount());
+        const AdjacencyIndex& upwardOut = hierarchy.getUpwardOut();
+        const AdjacencyIndex& upwardIn = hierarchy.getUpwardIn();
+        prepareWorkers();
+
+        // Backward searches; each worker collects its entries separately
+        for (auto& entries : workerEntries) entries.clear();
+        forEachParallel(targets.size(), [&](size_t column, size_t worker) {
+            const int target = targets[column];
+            if (target < 0 || target >= nodeCount) return;
+            upwardSearch(workspaces[worker], nodeCount, target, upwardIn, upwardOut, [&](int node, float distance) {
+                workerEntries[worker].push_back({node, static_cast<int>(column), distance});
+            });
+        });
+
+        // Group the entries by node (counting sort) so a forward search can
+        // scan one contiguous bucket per settled node
+        bucketOffsets.assign(nodeCount + 1, 0);
+        for (const auto& entries : workerEntries) {
+            for (const BucketEntry& entry : entries) ++bucketOffsets[entry.node + 1];
+        }
+        for (int node = 0; node < nodeCount; ++node) {
+            bucketOffsets[node + 1] += bucketOffsets[node];
+        }
+        buckets.resize(bucketOffsets[nodeCount]);
+        std::vector<int> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+        for (const auto& entries : workerEntries) {
+            for (const BucketEntry& entry : entries) buckets[cursor[entry.node]++] = entry;
+        }
+
+        forEachParallel(sources.size(), [&](size_t rowIndex, size_t worker) {
+            const int source = sources[rowIndex];
+            if (source < 0 || source >= nodeCount) return;
+            float* row = result.row(rowIndex);
+            upwardSearch(workspaces[worker], nodeCount, source, upwardOut, upwardIn, [&](int node, float distance) {
+                for (int k = bucketOffsets[node]; k < bucketOffsets[node + 1]; ++k) {
+                    const BucketEntry& entry = buckets[k];
+                    row[entry.column] = std::min(row[entry.column], distance + entry.distance);
+                }
+            });
+        });
+    }
+
+    void compute(const SearchGraph& graph, const std::vector<int>& sources,
+                 const std::vector<int>& targets, DistanceMatrix& result) {
+        result.resize(sources.size(), targets.size());
+        const int nodeCount = static_cast<int>(graph.nodeCount());
+        prepareWorkers();
+
+        isTarget.assign(nodeCount, 0);
+        size_t distinctTargets = 0;
+        for (int target : targets) {
+            if (target >= 0 && target < nodeCount && !isTarget[target]) {
+                isTarget[target] = 1;
+                ++distinctTargets;
+            }
+        }
+
+        for (Dijkstra& search : searches) search.setGraph(graph);
+        forEachParallel(sources.size(), [&](size_t rowIndex, size_t worker) {
+            const int source = sources[rowIndex];
+            if (source < 0 || source >= nodeCount) return;
+
+            Dijkstra& search = searches[worker];
+            size_t remaining = distinctTargets;
+            search.setQuery(source, -1);
+            while (remaining > 0 && search.step()) {
+                if (isTarget[search.getLastSettled()]) --remaining;
+            }
+
+            const SearchWorkspace& workspace = search.getWorkspace();
+            float* row = result.row(rowIndex);
+            for (size_t column = 0; column < targets.size(); ++column) {
+                const int target = targets[column];
+                if (target >= 0 && target < nodeCount && workspace.isSettled(target)) {
+                    row[column] = workspace.getDistance(target);
+                }
+            }
+        });
+    }
+
+private:
+    struct BucketEntry {
+        int node;
+        int column;
+        float distance;
+    };
+
+    ThreadPool* pool;
+    std::vector<SearchWorkspace> workspaces;
+    std::vector<Dijkstra> searches;
+    std::vector<std::vector<BucketEntry>> workerEntries;
+    std::vector<int> bucketOffsets;
+    std::vector<BucketEntry> buckets;
+    std::vector<char> isTarget;
+
+    void prepareWorkers() {
+        const size_t workers = pool ? pool->getThreadCount() : 1;
+        workspaces.resize(workers);
+        searches.resize(workers);
+        workerEntries.resize(workers);
+    }
+
+    // Runs body(item, worker) for every item, with worker telling which
+    // per-thread workspace the call may use.
+    template <typename Body>
+    void forEachParallel(size_t count, Body&& body) {
+        auto range = [&](size_t begin, size_t end, size_t worker) {
+            for (size_t item = begin; item < end; ++item) body(item, worker);
+        };
+        if (pool) {
+            pool->parallelFor(count, range);
+        } else {
+            range(0, count, 0);
+        }
+    }
+
+    // Exhaustive Dijkstra along upward arcs, reporting each settled node.
+    // A node is stalled, and neither reported nor expanded, if some more
+    // important neighbour already reaches it more cheaply through the
+    // opposite upward arcs: its distance here cannot be a shortest one.
+    template <typename Visit>
+    static void upwardSearch(SearchWorkspace& space, int nodeCount, int start, const AdjacencyIndex& upward,
+                             const AdjacencyIndex& opposite, Visit&& visit) {
+        space.prepare(nodeCount);
+        space.reach(start, 0.0f, -1, -1);
+        space.heap.push(start, 0.0f);
+
+        while (!space.heap.empty()) {
+            const int node = space.heap.pop();
+            const float distance = space.getDistance(node);
+            space.settle(node);
+
+            bool stalled = false;
+            for (int arc = opposite.begin(node); arc < opposite.end(node) && !stalled; ++arc) {
+                stalled = space.getDistance(opposite.targets[arc]) + opposite.weights[arc] < distance;
+            }
+            if (stalled) continue;
+
+            visit(node, distance);
+            for (int arc = upward.begin(node); arc < upward.end(node); ++arc) {
+                const int next = upward.targets[arc];
+                const float candidate = distance + upward.weights[arc];
+                if (candidate < space.getDistance(next)) {
+                    space.reach(next, candidate, node, upward.edgeIds[arc]);
+                    space.heap.pushOrDecrease(next, candidate);
+                }
+            }
+        }
+    }
+};
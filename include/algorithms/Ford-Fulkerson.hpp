@@ -5,4 +5,1103 @@
 #ifndef FORD_FULKERSON_HPP
 #define FORD_FULKERSON_HPP
 
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <atomic>
+#include <cstdint>
+#include "../MSTVisualization.hpp"
+#include "../Graph.hpp"
+#include "../ThreadPool.hpp"
+
+// An s-t cut: sourceSide[node] marks the nodes on the source's side and
+// edges lists the network edges crossing from that side to the other.
+struct MinCut {
+    std::vector<char> sourceSide;
+    std::vector<int> edges;
+    double capacity = 0;
+};
+
+// Residual network stored in flat arrays. Every edge becomes a pair of arcs,
+// forward and reverse, that point at each other through partners[]. After
+// finalize() the arcs are grouped by tail, so a node's arcs are the range
+// [begin(node), end(node)) of every array.
+class FlowNetwork {
+public:
+    using Capacity = double;
+
+    void clear(int nodeCount) {
+        nodes = nodeCount;
+        staged.clear();
+        offsets.assign(nodeCount + 1, 0);
+        heads.clear();
+        residuals.clear();
+        capacities.clear();
+        partners.clear();
+        edgeArcs.clear();
+        externalIds.clear();
+        dirty = true;
+    }
+
+    // An undirected edge is an arc pair with capacity in both directions.
+    // Returns the edge index used by getFlow() and the visualization state.
+    int addEdge(int from, int to, Capacity capacity, Capacity reverseCapacity = 0, int externalId = -1) {
+        if (from < 0 || to < 0 || from >= nodes || to >= nodes) {
+            throw std::runtime_error("Flow edge refers to a missing node");
+        }
+        staged.push_back({from, to, capacity, reverseCapacity});
+        externalIds.push_back(externalId);
+        dirty = true;
+        return static_cast<int>(staged.size()) - 1;
+    }
+
+    // Capacities come from edge weights (1 if unweighted); edge i of the
+    // network is edge i of the graph.
+    static FlowNetwork fromGraph(const Graph& graph) {
+        FlowNetwork network;
+        network.clear(static_cast<int>(graph.getNodes().size()));
+        const auto& edges = graph.getEdges();
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const Capacity capacity = edges[i]->getWeight().value_or(1.0f);
+            network.addEdge(graph.getNodeIndex(edges[i]->getStartNode()),
+                            graph.getNodeIndex(edges[i]->getEndNode()),
+                            capacity, graph.isDirected() ? 0 : capacity, static_cast<int>(i));
+        }
+        network.finalize();
+        return network;
+    }
+
+    // DIMACS max-flow format: "p max n m", "n id s", "n id t", "a u v cap",
+    // with 1-based node ids. Comment lines start with 'c'.
+    static FlowNetwork loadDimacs(const std::string& filename, int& source, int& sink) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        FlowNetwork network;
+        source = -1;
+        sink = -1;
+        bool hasProblem = false;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == 'c') continue;
+            std::istringstream fields(line);
+            char kind = 0;
+            fields >> kind;
+            if (kind == 'p') {
+                std::string type;
+                int nodeCount = 0;
+                int edgeCount = 0;
+                fields >> type >> nodeCount >> edgeCount;
+                network.clear(nodeCount);
+                network.staged.reserve(edgeCount);
+                hasProblem = true;
+            } else if (kind == 'n') {
+                int id = 0;
+                char role = 0;
+                fields >> id >> role;
+                (role == 's' ? source : sink) = id - 1;
+            } else if (kind == 'a') {
+                if (!hasProblem) throw std::runtime_error("Arc before problem line in " + filename);
+                int from = 0;
+                int to = 0;
+                Capacity capacity = 0;
+                fields >> from >> to >> capacity;
+                network.addEdge(from - 1, to - 1, capacity);
+            }
+            if (fields.fail()) {
+                throw std::runtime_error("Malformed DIMACS line in " + filename + ": " + line);
+            }
+        }
+
+        if (!hasProblem || source < 0 || sink < 0) {
+            throw std::runtime_error("Missing problem, source or sink line in " + filename);
+        }
+        network.finalize();
+        return network;
+    }
+
+    void finalize() {
+        if (!dirty) return;
+        dirty = false;
+
+        offsets.assign(nodes + 1, 0);
+        for (const StagedEdge& edge : staged) {
+            ++offsets[edge.from + 1];
+            ++offsets[edge.to + 1];
+        }
+        for (int node = 0; node < nodes; ++node) {
+            offsets[node + 1] += offsets[node];
+        }
+
+        const size_t arcTotal = staged.size() * 2;
+        heads.resize(arcTotal);
+        capacities.resize(arcTotal);
+        partners.resize(arcTotal);
+        edgeArcs.resize(staged.size());
+
+        std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < staged.size(); ++i) {
+            const StagedEdge& edge = staged[i];
+            const int forward = cursor[edge.from]++;
+            const int backward = cursor[edge.to]++;
+            heads[forward] = edge.to;
+            heads[backward] = edge.from;
+            capacities[forward] = edge.capacity;
+            capacities[backward] = edge.reverseCapacity;
+            partners[forward] = backward;
+            partners[backward] = forward;
+            edgeArcs[i] = forward;
+        }
+        residuals = capacities;
+    }
+
+    void resetFlow() {
+        finalize();
+        residuals = capacities;
+    }
+
+    int nodeCount() const { return nodes; }
+    int edgeCount() const { return static_cast<int>(staged.size()); }
+    int arcCount() const { return static_cast<int>(heads.size()); }
+
+    int begin(int node) const { return offsets[node]; }
+    int end(int node) const { return offsets[node + 1]; }
+    int getHead(int arc) const { return heads[arc]; }
+    int getTail(int arc) const { return heads[partners[arc]]; }
+    int getPartner(int arc) const { return partners[arc]; }
+    Capacity getResidual(int arc) const { return residuals[arc]; }
+    Capacity getArcCapacity(int arc) const { return capacities[arc]; }
+
+    // Moves amount of flow along arc.
+    void push(int arc, Capacity amount) {
+        residuals[arc] -= amount;
+        residuals[partners[arc]] += amount;
+    }
+
+    int getEdgeArc(int edge) const { return edgeArcs[edge]; }
+    int getExternalId(int edge) const { return externalIds[edge]; }
+    Capacity getCapacity(int edge) const { return staged[edge].capacity; }
+    // Net flow from the edge's tail to its head; negative if an undirected
+    // edge carries flow the other way.
+    Capacity getFlow(int edge) const {
+        const int arc = edgeArcs[edge];
+        return capacities[arc] - residuals[arc];
+    }
+
+    // After a maximum flow, the nodes still reachable from the source in the
+    // residual graph form the source side of a minimum cut, and the cut's
+    // capacity equals the flow value.
+    MinCut findMinCut(int source) const {
+        MinCut cut;
+        cut.sourceSide.assign(nodes, 0);
+        if (source < 0 || source >= nodes) return cut;
+
+        std::vector<int> queue{source};
+        cut.sourceSide[source] = 1;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int node = queue[head];
+            for (int arc = begin(node); arc < end(node); ++arc) {
+                if (residuals[arc] > 0 && !cut.sourceSide[heads[arc]]) {
+                    cut.sourceSide[heads[arc]] = 1;
+                    queue.push_back(heads[arc]);
+                }
+            }
+        }
+
+        for (int edge = 0; edge < edgeCount(); ++edge) {
+            const int arc = edgeArcs[edge];
+            const bool tailInside = cut.sourceSide[getTail(arc)];
+            const bool headInside = cut.sourceSide[heads[arc]];
+            const int crossing = tailInside && !headInside ? arc
+                               : headInside && !tailInside ? partners[arc] : -1;
+            if (crossing >= 0 && capacities[crossing] > 0) {
+                cut.edges.push_back(edge);
+                cut.capacity += capacities[crossing];
+            }
+        }
+        return cut;
+    }
+
+private:
+    struct StagedEdge {
+        int from;
+        int to;
+        Capacity capacity;
+        Capacity reverseCapacity;
+    };
+
+    int nodes = 0;
+    bool dirty = true;
+    std::vector<StagedEdge> staged;
+    std::vector<int> externalIds;
+    std::vector<int> offsets;
+    std::vector<int> heads;
+    std::vector<Capacity> residuals;
+    std::vector<Capacity> capacities;
+    std::vector<int> partners;
+    std::vector<int> edgeArcs;
+};
+
+// Common interface of the max-flow solvers. solve() runs to completion
+// without touching any visualization state. begin() followed by step()
+// advances one augmentation, phase or discharge per call and keeps node and
+// edge states in the MSTVisualization style for the UI to render.
+class MaxFlowAlgorithm : public MSTVisualization {
+public:
+    using Capacity = FlowNetwork::Capacity;
+
+    struct EdgeState {
+        sf::Color color;
+        std::string label;
+        bool isHighlighted;
+
+        EdgeState() : color(MSTColors::UNVISITED), isHighlighted(false) {}
+    };
+
+    virtual std::string getName() const = 0;
+    virtual std::string getDescription() const = 0;
+
+    Capacity solve(FlowNetwork& flowNetwork, int source, int sink) {
+        start(flowNetwork, source, sink, false);
+        while (!finished) {
+            finished = !advance();
+        }
+        return flowValue;
+    }
+
+    void begin(FlowNetwork& flowNetwork, int source, int sink) {
+        start(flowNetwork, source, sink, true);
+        addAlgorithmStep("Find the maximum flow from node " + std::to_string(source) +
+                         " to node " + std::to_string(sink));
+        refreshStates();
+    }
+
+    bool step() {
+        if (finished || !network) return false;
+        finished = !advance();
+        if (visualize) {
+            refreshStates();
+            if (finished) {
+                addAlgorithmStep("Maximum flow: " + formatWeight(static_cast<float>(flowValue)));
+                markMinCut();
+            }
+        }
+        return !finished;
+    }
+
+    bool isFinished() const { return finished; }
+    Capacity getFlowValue() const { return flowValue; }
+
+    // Only meaningful once the run has finished.
+    MinCut getMinCut() const {
+        return network ? network->findMinCut(source) : MinCut();
+    }
+
+    const EdgeState& getEdgeState(int edge) const {
+        return edge >= 0 && static_cast<size_t>(edge) < edgeStates.size() ? edgeStates[edge] : defaultEdgeState;
+    }
+
+protected:
+    FlowNetwork* network = nullptr;
+    int source = -1;
+    int sink = -1;
+    Capacity flowValue = 0;
+    bool visualize = false;
+    bool finished = true;
+    std::vector<EdgeState> edgeStates;
+
+    inline static EdgeState defaultEdgeState{};
+
+    // Called once per run after the network's flow has been cleared.
+    virtual void initialize() = 0;
+    // Performs one unit of work; returns false once the flow is maximum.
+    virtual bool advance() = 0;
+
+    void highlightArc(int arc) {
+        const int edge = edgeOfArc(arc);
+        if (edge >= 0) {
+            edgeStates[edge].isHighlighted = true;
+            edgeStates[edge].color = MSTColors::CONSIDERING;
+        }
+    }
+
+private:
+    // Arc -> edge lookup, only built for step mode.
+    std::vector<int> arcEdges;
+
+    void start(FlowNetwork& flowNetwork, int from, int to, bool withVisualization) {
+        network = &flowNetwork;
+        network->resetFlow();
+        source = from;
+        sink = to;
+        flowValue = 0;
+        visualize = withVisualization;
+        nodeStates.clear();
+        algorithmSteps.clear();
+        currentStep = 0;
+        edgeStates.clear();
+
+        const int nodeCount = network->nodeCount();
+        finished = from < 0 || to < 0 || from >= nodeCount || to >= nodeCount || from == to;
+        if (visualize) {
+            arcEdges.assign(network->arcCount(), -1);
+            for (int edge = 0; edge < network->edgeCount(); ++edge) {
+                arcEdges[network->getEdgeArc(edge)] = edge;
+                arcEdges[network->getPartner(network->getEdgeArc(edge))] = edge;
+            }
+        }
+        if (!finished) initialize();
+    }
+
+    void markMinCut() {
+        const MinCut cut = getMinCut();
+        for (int node = 0; node < network->nodeCount(); ++node) {
+            if (cut.sourceSide[node]) setNodeColor(node, MSTColors::IN_MST);
+        }
+        for (int edge : cut.edges) {
+            edgeStates[edge].isHighlighted = true;
+        }
+        addAlgorithmStep("Minimum cut: " + std::to_string(cut.edges.size()) + " edges, capacity " +
+                         formatWeight(static_cast<float>(cut.capacity)));
+    }
+
+    int edgeOfArc(int arc) const {
+        return arc >= 0 && static_cast<size_t>(arc) < arcEdges.size() ? arcEdges[arc] : -1;
+    }
+
+    void refreshStates() {
+        edgeStates.assign(network->edgeCount(), EdgeState());
+        for (int edge = 0; edge < network->edgeCount(); ++edge) {
+            EdgeState& state = edgeStates[edge];
+            const Capacity flow = network->getFlow(edge);
+            const int arc = network->getEdgeArc(edge);
+            const Capacity limit = flow >= 0 ? network->getArcCapacity(arc)
+                                             : network->getArcCapacity(network->getPartner(arc));
+            state.label = formatWeight(static_cast<float>(std::abs(flow))) + "/" +
+                          formatWeight(static_cast<float>(limit));
+            if (flow != 0 && std::abs(flow) >= limit) {
+                state.color = MSTColors::REJECTED;
+            } else if (flow != 0) {
+                state.color = MSTColors::IN_MST;
+            }
+        }
+
+        for (int node = 0; node < network->nodeCount(); ++node) {
+            setNodeColor(node, MSTColors::UNVISITED);
+            setNodeHighlight(node, false);
+        }
+        setNodeColor(source, MSTColors::IN_MST);
+        setNodeColor(sink, MSTColors::IN_MST);
+        setNodeLabel(source, "source");
+        setNodeLabel(sink, "sink");
+        markProgress();
+    }
+
+protected:
+    // Lets a solver colour what its last step touched.
+    virtual void markProgress() {}
+};
+
+// Shortest augmenting paths found by breadth-first search: O(V E^2), but
+// each step is one easy-to-follow path.
+class EdmondsKarp : public MaxFlowAlgorithm {
+public:
+    std::string getName() const override { return "Edmonds-Karp"; }
+    std::string getDescription() const override {
+        return "Repeatedly augments along a shortest path in the residual graph";
+    }
+
+protected:
+    void initialize() override {
+        parentArcs.assign(network->nodeCount(), -1);
+        lastPath.clear();
+    }
+
+    bool advance() override {
+        if (!findPath()) {
+            lastPath.clear();
+            return false;
+        }
+
+        Capacity bottleneck = std::numeric_limits<Capacity>::infinity();
+        for (int node = sink; node != source; node = network->getTail(parentArcs[node])) {
+            bottleneck = std::min(bottleneck, network->getResidual(parentArcs[node]));
+        }
+
+        lastPath.clear();
+        for (int node = sink; node != source; node = network->getTail(parentArcs[node])) {
+            network->push(parentArcs[node], bottleneck);
+            if (visualize) lastPath.push_back(parentArcs[node]);
+        }
+        flowValue += bottleneck;
+
+        if (visualize) {
+            addAlgorithmStep("Augmenting path of " + std::to_string(lastPath.size()) +
+                             " edges carries " + formatWeight(static_cast<float>(bottleneck)));
+        }
+        return true;
+    }
+
+    void markProgress() override {
+        for (int arc : lastPath) {
+            highlightArc(arc);
+            setNodeColor(network->getHead(arc), MSTColors::CONSIDERING);
+            setNodeHighlight(network->getHead(arc), true);
+        }
+    }
+
+private:
+    std::vector<int> parentArcs;
+    std::vector<int> queue;
+    std::vector<int> lastPath;
+
+    bool findPath() {
+        std::fill(parentArcs.begin(), parentArcs.end(), -1);
+        queue.clear();
+        queue.push_back(source);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int node = queue[head];
+            for (int arc = network->begin(node); arc < network->end(node); ++arc) {
+                const int next = network->getHead(arc);
+                if (network->getResidual(arc) <= 0 || next == source || parentArcs[next] != -1) continue;
+                parentArcs[next] = arc;
+                if (next == sink) return true;
+                queue.push_back(next);
+            }
+        }
+        return false;
+    }
+};
+
+// Dinic's algorithm: each phase builds BFS levels and saturates every
+// shortest path at once with a blocking flow. One step is one phase.
+class Dinic : public MaxFlowAlgorithm {
+public:
+    std::string getName() const override { return "Dinic"; }
+    std::string getDescription() const override {
+        return "Augments a blocking flow in the BFS level graph each phase";
+    }
+
+protected:
+    void initialize() override {
+        const int nodeCount = network->nodeCount();
+        levels.assign(nodeCount, -1);
+        currentArcs.assign(nodeCount, 0);
+        phase = 0;
+    }
+
+    bool advance() override {
+        if (!buildLevels()) return false;
+
+        for (int node = 0; node < network->nodeCount(); ++node) {
+            currentArcs[node] = network->begin(node);
+        }
+        const Capacity pushed = blockingFlow();
+        flowValue += pushed;
+        ++phase;
+
+        if (visualize) {
+            addAlgorithmStep("Phase " + std::to_string(phase) + ": sink at level " +
+                             std::to_string(levels[sink]) + ", pushed " +
+                             formatWeight(static_cast<float>(pushed)));
+        }
+        return true;
+    }
+
+    void markProgress() override {
+        for (int node = 0; node < network->nodeCount(); ++node) {
+            if (levels[node] >= 0 && node != source && node != sink) {
+                setNodeLabel(node, "level " + std::to_string(levels[node]));
+            }
+        }
+    }
+
+private:
+    std::vector<int> levels;
+    std::vector<int> currentArcs;
+    std::vector<int> queue;
+    std::vector<int> path;
+    int phase = 0;
+
+    bool buildLevels() {
+        std::fill(levels.begin(), levels.end(), -1);
+        levels[source] = 0;
+        queue.clear();
+        queue.push_back(source);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int node = queue[head];
+            for (int arc = network->begin(node); arc < network->end(node); ++arc) {
+                const int next = network->getHead(arc);
+                if (network->getResidual(arc) > 0 && levels[next] < 0) {
+                    levels[next] = levels[node] + 1;
+                    queue.push_back(next);
+                }
+            }
+        }
+        return levels[sink] >= 0;
+    }
+
+    // Iterative depth-first search along level-increasing arcs. Current-arc
+    // pointers skip arcs that are saturated or lead to dead ends, so every
+    // arc is abandoned at most once per phase.
+    Capacity blockingFlow() {
+        Capacity total = 0;
+        path.clear();
+        int node = source;
+
+        while (true) {
+            if (node == sink) {
+                Capacity bottleneck = std::numeric_limits<Capacity>::infinity();
+                for (int arc : path) bottleneck = std::min(bottleneck, network->getResidual(arc));
+
+                size_t firstSaturated = path.size();
+                for (size_t i = 0; i < path.size(); ++i) {
+                    network->push(path[i], bottleneck);
+                    if (firstSaturated == path.size() && network->getResidual(path[i]) <= 0) {
+                        firstSaturated = i;
+                    }
+                }
+                total += bottleneck;
+
+                // Resume from the tail of the first saturated arc
+                path.resize(firstSaturated);
+                node = path.empty() ? source : network->getHead(path.back());
+                continue;
+            }
+
+            int& arc = currentArcs[node];
+            while (arc < network->end(node) &&
+                   (network->getResidual(arc) <= 0 || levels[network->getHead(arc)] != levels[node] + 1)) {
+                ++arc;
+            }
+
+            if (arc < network->end(node)) {
+                path.push_back(arc);
+                node = network->getHead(arc);
+                continue;
+            }
+
+            // Dead end: no flow can pass through this node in this phase
+            levels[node] = -1;
+            if (path.empty()) break;
+            node = network->getTail(path.back());
+            path.pop_back();
+            ++currentArcs[node];
+        }
+        return total;
+    }
+};
+
+// Push-relabel with highest-label selection. Nodes hold excess and a height
+// label; excess moves one arc downhill at a time. Periodic global relabeling
+// recomputes exact distances to the sink by backward BFS, and the gap
+// heuristic lifts every node above an emptied height straight to n, since
+// none of them can reach the sink any more.
+//
+// The first stage computes a maximum preflow, whose value is the flow. The
+// second returns leftover excess to the source so that getFlow() describes
+// a valid flow. One step is one discharge.
+class PushRelabel : public MaxFlowAlgorithm {
+public:
+    std::string getName() const override { return "Push-Relabel"; }
+    std::string getDescription() const override {
+        return "Pushes excess downhill from the highest active node, relabeling when stuck";
+    }
+
+protected:
+    void initialize() override {
+        saturateSource();
+        globalRelabel();
+    }
+
+    bool advance() override {
+        if (!returning) {
+            const int node = popHighestActive();
+            if (node != NONE) {
+                discharge(node);
+                if (work > GLOBAL_RELABEL_FACTOR * nodeCount + network->arcCount()) {
+                    globalRelabel();
+                }
+                return true;
+            }
+            startReturn();
+        }
+        return advanceReturn();
+    }
+
+    void markProgress() override {
+        for (int node = 0; node < nodeCount; ++node) {
+            if (node == source || node == sink) continue;
+            if (excess[node] > 0) setNodeColor(node, MSTColors::PROCESSING);
+            setNodeLabel(node, "h=" + std::to_string(heights[node]) + " e=" +
+                               formatWeight(static_cast<float>(excess[node])));
+        }
+        if (lastDischarged != NONE) {
+            setNodeColor(lastDischarged, MSTColors::CURRENT);
+            setNodeHighlight(lastDischarged, true);
+        }
+    }
+
+    static constexpr int NONE = -1;
+    // Global relabel once relabel work exceeds this many units per node
+    // plus one per arc.
+    static constexpr long GLOBAL_RELABEL_FACTOR = 6;
+    static constexpr long RELABEL_WORK = 12;
+
+    int nodeCount = 0;
+    std::vector<int> heights;
+    std::vector<Capacity> excess;
+    std::vector<int> currentArcs;
+    long work = 0;
+    int lastDischarged = NONE;
+    bool returning = false;
+    std::vector<int> returnQueue;
+    size_t queueHead = 0;
+    std::vector<int> bfsQueue;
+
+    // Resets the per-node arrays and pushes every source arc to capacity.
+    void saturateSource() {
+        nodeCount = network->nodeCount();
+        heights.assign(nodeCount, nodeCount);
+        excess.assign(nodeCount, 0);
+        currentArcs.assign(nodeCount, 0);
+        activeNext.assign(nodeCount, NONE);
+        allNext.assign(nodeCount, NONE);
+        allPrev.assign(nodeCount, NONE);
+        activeHeads.assign(nodeCount + 1, NONE);
+        allHeads.assign(nodeCount + 1, NONE);
+        lastDischarged = -1;
+        returning = false;
+
+        for (int arc = network->begin(source); arc < network->end(source); ++arc) {
+            const Capacity amount = network->getResidual(arc);
+            if (amount <= 0) continue;
+            network->push(arc, amount);
+            excess[network->getHead(arc)] += amount;
+            excess[source] -= amount;
+        }
+    }
+
+    // Second stage: heights become BFS distances to the source, and nodes
+    // with excess discharge towards it in FIFO order. The sink is excluded,
+    // because the preflow is already maximum.
+    void startReturn() {
+        flowValue = excess[sink];
+        if (visualize) {
+            addAlgorithmStep("Maximum preflow found; returning leftover excess to the source");
+        }
+
+        returning = true;
+        lastDischarged = NONE;
+        std::fill(heights.begin(), heights.end(), std::numeric_limits<int>::max());
+        heights[source] = 0;
+        bfsQueue.clear();
+        bfsQueue.push_back(source);
+        for (size_t head = 0; head < bfsQueue.size(); ++head) {
+            const int node = bfsQueue[head];
+            for (int arc = network->begin(node); arc < network->end(node); ++arc) {
+                const int previous = network->getHead(arc);
+                if (previous == sink || heights[previous] != std::numeric_limits<int>::max()) continue;
+                if (network->getResidual(network->getPartner(arc)) > 0) {
+                    heights[previous] = heights[node] + 1;
+                    bfsQueue.push_back(previous);
+                }
+            }
+        }
+
+        returnQueue.clear();
+        queueHead = 0;
+        for (int node = 0; node < nodeCount; ++node) {
+            currentArcs[node] = network->begin(node);
+            if (node != source && node != sink && excess[node] > 0) returnQueue.push_back(node);
+        }
+    }
+
+    bool advanceReturn() {
+        if (queueHead < returnQueue.size()) {
+            returnExcess(returnQueue[queueHead++]);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    // Active nodes per height (singly linked) and all nodes below n per
+    // height (doubly linked, for the gap heuristic).
+    std::vector<int> activeNext;
+    std::vector<int> allNext;
+    std::vector<int> allPrev;
+    std::vector<int> activeHeads;
+    std::vector<int> allHeads;
+    int maxActive = NONE;
+    int maxHeight = 0;
+
+    void addActive(int node) {
+        const int height = heights[node];
+        activeNext[node] = activeHeads[height];
+        activeHeads[height] = node;
+        maxActive = std::max(maxActive, height);
+    }
+
+    int popHighestActive() {
+        while (maxActive >= 0 && activeHeads[maxActive] == NONE) --maxActive;
+        if (maxActive < 0) return NONE;
+        const int node = activeHeads[maxActive];
+        activeHeads[maxActive] = activeNext[node];
+        return node;
+    }
+
+    void addToLayer(int node) {
+        const int height = heights[node];
+        allPrev[node] = NONE;
+        allNext[node] = allHeads[height];
+        if (allHeads[height] != NONE) allPrev[allHeads[height]] = node;
+        allHeads[height] = node;
+        maxHeight = std::max(maxHeight, height);
+    }
+
+    void removeFromLayer(int node) {
+        const int height = heights[node];
+        if (allPrev[node] != NONE) {
+            allNext[allPrev[node]] = allNext[node];
+        } else {
+            allHeads[height] = allNext[node];
+        }
+        if (allNext[node] != NONE) allPrev[allNext[node]] = allPrev[node];
+    }
+
+    // Exact distances to the sink in the residual graph; nodes that cannot
+    // reach it get height n and drop out of the first stage.
+    void globalRelabel() {
+        work = 0;
+        std::fill(heights.begin(), heights.end(), nodeCount);
+        std::fill(activeHeads.begin(), activeHeads.end(), NONE);
+        std::fill(allHeads.begin(), allHeads.end(), NONE);
+        maxActive = NONE;
+        maxHeight = 0;
+
+        heights[sink] = 0;
+        bfsQueue.clear();
+        bfsQueue.push_back(sink);
+        for (size_t head = 0; head < bfsQueue.size(); ++head) {
+            const int node = bfsQueue[head];
+            addToLayer(node);
+            if (excess[node] > 0 && node != sink) addActive(node);
+
+            for (int arc = network->begin(node); arc < network->end(node); ++arc) {
+                const int previous = network->getHead(arc);
+                if (previous == source || heights[previous] < nodeCount) continue;
+                if (network->getResidual(network->getPartner(arc)) > 0) {
+                    heights[previous] = heights[node] + 1;
+                    bfsQueue.push_back(previous);
+                }
+            }
+        }
+
+        for (int node = 0; node < nodeCount; ++node) {
+            currentArcs[node] = network->begin(node);
+        }
+    }
+
+    void pushExcess(int node, int arc, int next) {
+        const Capacity amount = std::min(excess[node], network->getResidual(arc));
+        if (excess[next] == 0 && next != sink && next != source) addActive(next);
+        network->push(arc, amount);
+        excess[node] -= amount;
+        excess[next] += amount;
+    }
+
+    void discharge(int node) {
+        lastDischarged = node;
+        while (true) {
+            const int height = heights[node];
+            for (int arc = currentArcs[node]; arc < network->end(node); ++arc) {
+                if (network->getResidual(arc) <= 0) continue;
+                const int next = network->getHead(arc);
+                if (heights[next] != height - 1) continue;
+
+                pushExcess(node, arc, next);
+                if (excess[node] == 0) {
+                    currentArcs[node] = arc;
+                    return;
+                }
+            }
+
+            if (relabel(node) >= nodeCount) return;
+        }
+    }
+
+    // Lifts node to one above its lowest residual neighbour, or applies the
+    // gap heuristic if node was the last one at its height.
+    int relabel(int node) {
+        const int oldHeight = heights[node];
+        removeFromLayer(node);
+
+        if (allHeads[oldHeight] == NONE) {
+            for (int height = oldHeight + 1; height <= maxHeight; ++height) {
+                for (int other = allHeads[height]; other != NONE; other = allNext[other]) {
+                    heights[other] = nodeCount;
+                }
+                allHeads[height] = NONE;
+                activeHeads[height] = NONE;
+            }
+            maxHeight = oldHeight - 1;
+            heights[node] = nodeCount;
+            return nodeCount;
+        }
+
+        int lowest = nodeCount;
+        int lowestArc = network->begin(node);
+        for (int arc = network->begin(node); arc < network->end(node); ++arc) {
+            if (network->getResidual(arc) > 0 && heights[network->getHead(arc)] + 1 < lowest) {
+                lowest = heights[network->getHead(arc)] + 1;
+                lowestArc = arc;
+            }
+        }
+        work += RELABEL_WORK + network->end(node) - network->begin(node);
+
+        heights[node] = lowest;
+        currentArcs[node] = lowestArc;
+        if (lowest < nodeCount) addToLayer(node);
+        return lowest;
+    }
+
+    void returnExcess(int node) {
+        lastDischarged = node;
+        while (excess[node] > 0) {
+            int& arc = currentArcs[node];
+            if (arc == network->end(node)) {
+                int lowest = std::numeric_limits<int>::max();
+                for (int candidate = network->begin(node); candidate < network->end(node); ++candidate) {
+                    const int next = network->getHead(candidate);
+                    if (next != sink && network->getResidual(candidate) > 0 &&
+                        heights[next] != std::numeric_limits<int>::max()) {
+                        lowest = std::min(lowest, heights[next] + 1);
+                    }
+                }
+                // Unreachable for a valid preflow: excess always has a way back
+                if (lowest == std::numeric_limits<int>::max()) return;
+                heights[node] = lowest;
+                arc = network->begin(node);
+                continue;
+            }
+
+            const int next = network->getHead(arc);
+            if (next != sink && network->getResidual(arc) > 0 && heights[next] == heights[node] - 1) {
+                const Capacity amount = std::min(excess[node], network->getResidual(arc));
+                if (excess[next] == 0 && next != source) returnQueue.push_back(next);
+                network->push(arc, amount);
+                excess[node] -= amount;
+                excess[next] += amount;
+                if (excess[node] == 0) return;
+            }
+            ++arc;
+        }
+    }
+};
+
+// Synchronous parallel push-relabel. A round processes every active node at
+// once in two passes over the thread pool. First each node pushes along
+// arcs admissible under the labels from the start of the round, then each
+// node still holding excess relabels from those same labels.
+//
+// A push v->w needs h(v) = h(w) + 1, so w cannot push back along that arc
+// pair in the same round, and residual capacities need no locking. Only the
+// excess a node receives is added atomically, into a buffer applied between
+// rounds. Global relabels run as a level-synchronous parallel BFS. The gap
+// heuristic is left out, since it would need shared height buckets. Leftover
+// excess goes back to the source sequentially, as in PushRelabel. One step
+// is one round.
+class ParallelPushRelabel : public PushRelabel {
+public:
+    explicit ParallelPushRelabel(ThreadPool* threadPool = nullptr) : pool(threadPool) {}
+
+    void setThreadPool(ThreadPool* threadPool) { pool = threadPool; }
+
+    std::string getName() const override { return "Parallel Push-Relabel"; }
+    std::string getDescription() const override {
+        return "Pushes and relabels all active nodes in synchronous parallel rounds";
+    }
+
+protected:
+    void initialize() override {
+        saturateSource();
+        incoming.assign(nodeCount, 0);
+        newHeights.assign(nodeCount, 0);
+        stamps.assign(nodeCount, 0);
+        round = 0;
+        const size_t workers = pool ? pool->getThreadCount() : 1;
+        discovered.assign(workers, {});
+        workerWork.assign(workers, 0);
+        parallelGlobalRelabel();
+    }
+
+    bool advance() override {
+        if (!returning) {
+            if (!active.empty()) {
+                runRound();
+                return true;
+            }
+            startReturn();
+        }
+        return advanceReturn();
+    }
+
+private:
+    static constexpr size_t PARALLEL_THRESHOLD = 256;
+
+    ThreadPool* pool;
+    std::vector<int> active;
+    std::vector<int> nextActive;
+    std::vector<Capacity> incoming;
+    std::vector<int> newHeights;
+    // Round in which a node was last queued, so each joins a round once
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t round = 0;
+    std::vector<std::vector<int>> discovered;
+    std::vector<long> workerWork;
+
+    template <typename Body>
+    void forEachRange(size_t count, Body&& body) {
+        if (pool && count >= PARALLEL_THRESHOLD) {
+            pool->parallelFor(count, body);
+        } else if (count > 0) {
+            body(0, count, 0);
+        }
+    }
+
+    void runRound() {
+        ++round;
+        for (int node : active) stamps[node] = round;
+
+        forEachRange(active.size(), [&](size_t begin, size_t end, size_t worker) {
+            std::vector<int>& found = discovered[worker];
+            for (size_t k = begin; k < end; ++k) {
+                const int node = active[k];
+                const int height = heights[node];
+                for (int arc = network->begin(node); arc < network->end(node); ++arc) {
+                    // Check the label first: the partner arc of an
+                    // inadmissible pair may be in use by the other node
+                    const int next = network->getHead(arc);
+                    if (heights[next] != height - 1) continue;
+                    const Capacity residual = network->getResidual(arc);
+                    if (residual <= 0) continue;
+
+                    const Capacity amount = std::min(excess[node], residual);
+                    network->push(arc, amount);
+                    excess[node] -= amount;
+                    std::atomic_ref<Capacity>(incoming[next]).fetch_add(amount, std::memory_order_relaxed);
+                    if (next != sink && std::atomic_ref<std::uint32_t>(stamps[next]).exchange(round) != round) {
+                        found.push_back(next);
+                    }
+                    if (excess[node] == 0) break;
+                }
+            }
+        });
+
+        forEachRange(active.size(), [&](size_t begin, size_t end, size_t worker) {
+            for (size_t k = begin; k < end; ++k) {
+                const int node = active[k];
+                if (excess[node] == 0) {
+                    newHeights[node] = heights[node];
+                    continue;
+                }
+                int lowest = nodeCount;
+                for (int arc = network->begin(node); arc < network->end(node); ++arc) {
+                    if (network->getResidual(arc) > 0) {
+                        lowest = std::min(lowest, heights[network->getHead(arc)] + 1);
+                    }
+                }
+                newHeights[node] = lowest;
+                workerWork[worker] += RELABEL_WORK + network->end(node) - network->begin(node);
+            }
+        });
+
+        nextActive.clear();
+        for (int node : active) {
+            heights[node] = newHeights[node];
+            collect(node);
+        }
+        for (std::vector<int>& found : discovered) {
+            for (int node : found) collect(node);
+            found.clear();
+        }
+        excess[sink] += incoming[sink];
+        incoming[sink] = 0;
+        active.swap(nextActive);
+
+        for (long& amount : workerWork) {
+            work += amount;
+            amount = 0;
+        }
+        if (work > GLOBAL_RELABEL_FACTOR * nodeCount + network->arcCount()) {
+            parallelGlobalRelabel();
+        }
+    }
+
+    void collect(int node) {
+        excess[node] += incoming[node];
+        incoming[node] = 0;
+        if (excess[node] > 0 && heights[node] < nodeCount) nextActive.push_back(node);
+    }
+
+    void parallelGlobalRelabel() {
+        work = 0;
+        std::fill(heights.begin(), heights.end(), nodeCount);
+        heights[sink] = 0;
+
+        std::vector<int>& frontier = nextActive;
+        frontier.assign(1, sink);
+        while (!frontier.empty()) {
+            forEachRange(frontier.size(), [&](size_t begin, size_t end, size_t worker) {
+                std::vector<int>& found = discovered[worker];
+                for (size_t k = begin; k < end; ++k) {
+                    const int node = frontier[k];
+                    const int level = heights[node] + 1;
+                    for (int arc = network->begin(node); arc < network->end(node); ++arc) {
+                        const int previous = network->getHead(arc);
+                        if (previous == source || network->getResidual(network->getPartner(arc)) <= 0) continue;
+                        std::atomic_ref<int> height(heights[previous]);
+                        int unvisited = nodeCount;
+                        if (height.load(std::memory_order_relaxed) == nodeCount &&
+                            height.compare_exchange_strong(unvisited, level, std::memory_order_relaxed)) {
+                            found.push_back(previous);
+                        }
+                    }
+                }
+            });
+
+            frontier.clear();
+            for (std::vector<int>& found : discovered) {
+                frontier.insert(frontier.end(), found.begin(), found.end());
+                found.clear();
+            }
+        }
+
+        active.clear();
+        for (int node = 0; node < nodeCount; ++node) {
+            if (node != source && node != sink && excess[node] > 0 && heights[node] < nodeCount) {
+                active.push_back(node);
+            }
+        }
+    }
+};
+
+// Shows a cut of a network built with FlowNetwork::fromGraph() on the graph.
+inline void highlightMinCut(Graph& graph, const FlowNetwork& network, const MinCut& cut) {
+    std::vector<int> graphEdges;
+    graphEdges.reserve(cut.edges.size());
+    for (int edge : cut.edges) {
+        if (network.getExternalId(edge) >= 0) graphEdges.push_back(network.getExternalId(edge));
+    }
+    graph.highlightCut(cut.sourceSide, graphEdges);
+}
+
 #endif //FORD_FULKERSON_HPP
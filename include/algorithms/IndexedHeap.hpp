@@ -0,0 +1,128 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Min-heap of integer ids in [0, capacity) with a stored key per id and
+// decrease-key. Each id's position in the heap is tracked, so contains() and
+// decreaseKey() are O(1) and O(log n). A wider node (Arity 4 by default) keeps
+// the tree shallow and each sift-down scans adjacent entries.
+template <typename Key, unsigned Arity = 4>
+class IndexedHeap {
+public:
+    static_assert(Arity >= 2, "heap arity must be at least 2");
+
+    // Sizes the position table for ids below capacity and empties the heap.
+    void resize(size_t capacity) {
+        if (positions.size() != capacity) {
+            positions.assign(capacity, NOT_IN_HEAP);
+            entries.clear();
+        } else {
+            clear();
+        }
+    }
+
+    size_t capacity() const { return positions.size(); }
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    bool contains(int id) const { return positions[id] != NOT_IN_HEAP; }
+
+    int top() const { return entries.front().id; }
+    Key topKey() const { return entries.front().key; }
+    Key keyOf(int id) const { return entries[positions[id]].key; }
+
+    void push(int id, Key key) {
+        positions[id] = static_cast<int>(entries.size());
+        entries.push_back({key, id});
+        siftUp(entries.size() - 1);
+    }
+
+    void decreaseKey(int id, Key key) {
+        size_t index = positions[id];
+        entries[index].key = key;
+        siftUp(index);
+    }
+
+    // Inserts the id or lowers its key. Returns false if the stored key was
+    // already at most key.
+    bool pushOrDecrease(int id, Key key) {
+        if (!contains(id)) {
+            push(id, key);
+            return true;
+        }
+        if (!(key < keyOf(id))) return false;
+        decreaseKey(id, key);
+        return true;
+    }
+
+    int pop() {
+        int id = entries.front().id;
+        positions[id] = NOT_IN_HEAP;
+
+        Entry last = entries.back();
+        entries.pop_back();
+        if (!entries.empty()) {
+            entries.front() = last;
+            positions[last.id] = 0;
+            siftDown(0);
+        }
+        return id;
+    }
+
+    // Costs O(size()), not O(capacity()), so a mostly-empty heap is cheap to reuse.
+    void clear() {
+        for (const Entry& entry : entries) {
+            positions[entry.id] = NOT_IN_HEAP;
+        }
+        entries.clear();
+    }
+
+private:
+    static constexpr int NOT_IN_HEAP = -1;
+
+    struct Entry {
+        Key key;
+        int id;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<int> positions;
+
+    void place(size_t index, const Entry& entry) {
+        entries[index] = entry;
+        positions[entry.id] = static_cast<int>(index);
+    }
+
+    void siftUp(size_t index) {
+        Entry moving = entries[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / Arity;
+            if (!(moving.key < entries[parent].key)) break;
+            place(index, entries[parent]);
+            index = parent;
+        }
+        place(index, moving);
+    }
+
+    void siftDown(size_t index) {
+        Entry moving = entries[index];
+        const size_t count = entries.size();
+
+        while (true) {
+            size_t firstChild = index * Arity + 1;
+            if (firstChild >= count) break;
+
+            size_t lastChild = firstChild + Arity < count ? firstChild + Arity : count;
+            size_t best = firstChild;
+            for (size_t child = firstChild + 1; child < lastChild; ++child) {
+                if (entries[child].key < entries[best].key) {
+                    best = child;
+                }
+            }
+
+            if (!(entries[best].key < moving.key)) break;
+            place(index, entries[best]);
+            index = best;
+        }
+        place(index, moving);
+    }
+};
@@ -1,13 +1,17 @@
 #pragma once
 #include "MSTAlgorithm.hpp"
+#include "DisjointSet.hpp"
+#include "../ThreadPool.hpp"
 #include <queue>
 #include <sstream>
+#include <algorithm>
+#include <random>
 
 class KruskalMST : public MSTAlgorithm {
 private:
     std::priority_queue<WeightedEdge, std::vector<WeightedEdge>, std::greater<WeightedEdge>> edgeQueue;
-    std::vector<WeightedEdge> allEdges;
     WeightedEdge currentEdge;
+    std::vector<char> nodeInMST;
     bool initialized;
     bool hasCurrentEdge;
     std::stringstream summary;
@@ -32,37 +36,32 @@ public:
         return "Finds MST by repeatedly selecting the minimum weight edge that doesn't create a cycle";
     }
 
-    void execute(std::vector<std::unique_ptr<Node>>& nodes) override {
-        parent.resize(nodes.size());
-        rank.resize(nodes.size());
+    void initialize(size_t nodeCount) override {
+        resizeSets(nodeCount);
+        nodeInMST.assign(nodeCount, 0);
         mstEdges.clear();
         nodeStates.clear();
         algorithmSteps.clear();
         currentStep = 0;
-        allEdges.clear();
         hasCurrentEdge = false;
         totalWeight = 0;
         summary.str("");
         summary.clear();
 
-        for (size_t i = 0; i < nodes.size(); i++) {
+        for (size_t i = 0; i < nodeCount; i++) {
             makeSet(i);
             setNodeColor(i, MSTColors::UNVISITED);
             setNodeHighlight(i, false);
             setPulseEffect(i, 0.0f);
         }
 
-        while (!edgeQueue.empty()) edgeQueue.pop();
-        for (const auto& edge : edges) {
-            edgeQueue.push(edge);
-            allEdges.push_back(edge);
-        }
+        fillEdgeQueue();
 
         currentStepPhase = StepPhase::INIT;
         initialized = false;
         finished = false;
 
-        addAlgorithmStep("Initialized with " + std::to_string(nodes.size()) + " nodes and " +
+        addAlgorithmStep("Initialized with " + std::to_string(nodeCount) + " nodes and " +
                         std::to_string(edges.size()) + " edges");
     }
 
@@ -96,7 +95,6 @@ public:
     void reset() override {
         MSTAlgorithm::reset();
         while (!edgeQueue.empty()) edgeQueue.pop();
-        allEdges.clear();
         hasCurrentEdge = false;
         totalWeight = 0;
         summary.str("");
@@ -106,7 +104,122 @@ public:
         finished = false;
     }
 
+    // Non-visual fast paths over the edges added so far: no node states or
+    // step log. The edge list is reordered in place rather than copied, and
+    // ties are broken by edge id, so both paths pick the same forest.
+    const std::vector<WeightedEdge>& computeSorted(ThreadPool* pool = nullptr) {
+        prepareFastPath();
+        sortEdges(edges.begin(), edges.end(), pool);
+        addLightestEdges(edges.begin(), edges.end());
+        finished = true;
+        return mstEdges;
+    }
+
+    // Filter-Kruskal: partition around a sampled pivot, solve the light
+    // part, then drop heavy edges whose ends are already connected before
+    // recursing into the rest. On dense graphs most heavy edges are thrown
+    // away without ever being sorted.
+    const std::vector<WeightedEdge>& computeFiltered(ThreadPool* pool = nullptr) {
+        prepareFastPath();
+        filterKruskal(edges.begin(), edges.end(), pool);
+        finished = true;
+        return mstEdges;
+    }
+
+    float getTotalWeight() const { return totalWeight; }
+
 private:
+    using EdgeIterator = std::vector<WeightedEdge>::iterator;
+
+    // Below this many edges Filter-Kruskal just sorts.
+    static constexpr size_t FILTER_BASE_SIZE = 1 << 12;
+
+    std::vector<char> keepFlags;
+    std::mt19937 pivotRandom{0x5eed};
+
+    static bool lighterEdge(const WeightedEdge& a, const WeightedEdge& b) {
+        return a.weight < b.weight || (a.weight == b.weight && a.id < b.id);
+    }
+
+    void prepareFastPath() {
+        sets.reset(countNodes());
+        mstEdges.clear();
+        totalWeight = 0;
+    }
+
+    static void sortEdges(EdgeIterator first, EdgeIterator last, ThreadPool* pool) {
+        if (pool) {
+            pool->parallelSort(first, last, lighterEdge);
+        } else {
+            std::sort(first, last, lighterEdge);
+        }
+    }
+
+    void addLightestEdges(EdgeIterator first, EdgeIterator last) {
+        for (; first != last && sets.setCount() > 1; ++first) {
+            if (sets.unite(first->src, first->dest)) {
+                mstEdges.push_back(*first);
+                totalWeight += first->weight;
+            }
+        }
+    }
+
+    void filterKruskal(EdgeIterator first, EdgeIterator last, ThreadPool* pool) {
+        const size_t count = static_cast<size_t>(last - first);
+        if (count <= std::max(FILTER_BASE_SIZE, sets.size() / 2)) {
+            sortEdges(first, last, pool);
+            addLightestEdges(first, last);
+            return;
+        }
+
+        std::uniform_int_distribution<size_t> pick(0, count - 1);
+        WeightedEdge samples[3] = {first[pick(pivotRandom)], first[pick(pivotRandom)], first[pick(pivotRandom)]};
+        std::sort(samples, samples + 3, lighterEdge);
+        const WeightedEdge pivot = samples[1];
+
+        EdgeIterator middle = std::partition(first, last, [&](const WeightedEdge& edge) {
+            return !lighterEdge(pivot, edge);
+        });
+        if (middle == last) {
+            sortEdges(first, last, pool);
+            addLightestEdges(first, last);
+            return;
+        }
+
+        filterKruskal(first, middle, pool);
+        if (sets.setCount() <= 1) return;
+        filterKruskal(middle, dropConnected(middle, last, pool), pool);
+    }
+
+    // Moves edges that would close a cycle to the back and returns where
+    // they start. Edges are swapped, not overwritten, so the list keeps
+    // every edge for later runs.
+    EdgeIterator dropConnected(EdgeIterator first, EdgeIterator last, ThreadPool* pool) {
+        const size_t count = static_cast<size_t>(last - first);
+        keepFlags.resize(count);
+        auto mark = [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                keepFlags[i] = sets.findRoot(first[i].src) != sets.findRoot(first[i].dest);
+            }
+        };
+        if (pool) {
+            pool->parallelFor(count, mark);
+        } else {
+            mark(0, count, 0);
+        }
+
+        size_t low = 0;
+        size_t high = count;
+        while (true) {
+            while (low < high && keepFlags[low]) ++low;
+            while (low < high && !keepFlags[high - 1]) --high;
+            if (low >= high) break;
+            std::swap(first[low], first[high - 1]);
+            std::swap(keepFlags[low], keepFlags[high - 1]);
+        }
+        return first + low;
+    }
+
     void handleInitPhase() {
         if (!initialized) {
             initialized = true;
@@ -115,8 +228,15 @@ private:
         }
     }
 
+    // Heapifies a copy of the edge list in O(E) instead of pushing one by one.
+    void fillEdgeQueue() {
+        edgeQueue = decltype(edgeQueue)(std::greater<WeightedEdge>(), edges);
+    }
+
+    // Stops once the tree spans every node; the remaining edges could only
+    // close cycles.
     void handleSortingPhase() {
-        if (!edgeQueue.empty()) {
+        if (!edgeQueue.empty() && sets.setCount() > 1) {
             if (hasCurrentEdge) {
                 updateNodeColors(currentEdge, false);
             }
@@ -125,7 +245,9 @@ private:
             hasCurrentEdge = true;
 
             updateNodeColors(currentEdge, true);
-            addAlgorithmStep("Considering edge " + currentEdge.description);
+            if (isVisualizing()) {
+                addAlgorithmStep("Considering edge " + describeEdge(currentEdge));
+            }
             currentStepPhase = StepPhase::PROCESSING;
         } else {
             currentStepPhase = StepPhase::FINALIZING;
@@ -134,12 +256,14 @@ private:
 
     void handleProcessingPhase() {
         if (hasCurrentEdge) {
-            int set1 = findSet(currentEdge.src);
-            int set2 = findSet(currentEdge.dest);
+            int set1 = sets.find(currentEdge.src);
+            int set2 = sets.find(currentEdge.dest);
 
             if (set1 != set2) {
                 unionSets(set1, set2);
                 mstEdges.push_back(currentEdge);
+                nodeInMST[currentEdge.src] = 1;
+                nodeInMST[currentEdge.dest] = 1;
                 totalWeight += currentEdge.weight;
 
                 setNodeColor(currentEdge.src, MSTColors::IN_MST);
@@ -147,12 +271,15 @@ private:
                 setPulseEffect(currentEdge.src, 1.0f);
                 setPulseEffect(currentEdge.dest, 1.0f);
 
-                std::string edgeInfo = formatEdgeInfo(currentEdge);
-                addAlgorithmStep("Added " + edgeInfo);
+                if (isVisualizing()) {
+                    addAlgorithmStep("Added " + formatEdgeInfo(currentEdge));
+                }
             } else {
                 setNodeColor(currentEdge.src, MSTColors::REJECTED);
                 setNodeColor(currentEdge.dest, MSTColors::REJECTED);
-                addAlgorithmStep("Skipped edge " + currentEdge.description + " (would create cycle)");
+                if (isVisualizing()) {
+                    addAlgorithmStep("Skipped edge " + describeEdge(currentEdge) + " (would create cycle)");
+                }
             }
 
             hasCurrentEdge = false;
@@ -161,6 +288,11 @@ private:
     }
 
     void handleFinalizingPhase() {
+        if (!isVisualizing()) {
+            currentStepPhase = StepPhase::COMPLETE;
+            return;
+        }
+
         for (const auto& edge : mstEdges) {
             setNodeColor(edge.src, MSTColors::IN_MST);
             setNodeColor(edge.dest, MSTColors::IN_MST);
@@ -186,6 +318,7 @@ private:
     }
 
     void updateNodeColors(const WeightedEdge& edge, bool highlight) {
+        if (!isVisualizing()) return;
         if (highlight) {
             setNodeColor(edge.src, MSTColors::CONSIDERING);
             setNodeColor(edge.dest, MSTColors::CONSIDERING);
@@ -208,14 +341,12 @@ private:
     }
 
     bool isNodeInMST(int nodeId) {
-        return std::any_of(mstEdges.begin(), mstEdges.end(),
-            [nodeId](const WeightedEdge& e) {
-                return e.src == nodeId || e.dest == nodeId;
-            });
+        return nodeInMST[nodeId];
     }
 
     void resetForNextIteration() {
-        for (size_t i = 0; i < parent.size(); i++) {
+        resizeSets(sets.size());
+        for (size_t i = 0; i < sets.size(); i++) {
             makeSet(i);
             setNodeColor(i, MSTColors::UNVISITED);
             setNodeHighlight(i, false);
@@ -223,10 +354,8 @@ private:
         }
 
         mstEdges.clear();
-        while (!edgeQueue.empty()) edgeQueue.pop();
-        for (const auto& edge : allEdges) {
-            edgeQueue.push(edge);
-        }
+        nodeInMST.assign(sets.size(), 0);
+        fillEdgeQueue();
 
         hasCurrentEdge = false;
         totalWeight = 0;
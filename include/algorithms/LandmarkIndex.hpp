@@ -0,0 +1,349 @@
+#pragma once
+#include "PathFinding.hpp"
+#include "../Graph.hpp"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+
+// ALT preprocessing: exact distances from and to a few landmark nodes. By
+// the triangle inequality, for any landmark L
+//     d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L),
+// which gives an A* estimate for any graph, embedded or not. Tables are
+// node-major (k floats per node) so one estimate reads one contiguous row
+// per table.
+class LandmarkIndex {
+public:
+    enum class Selection {
+        FARTHEST,   // each landmark is the node farthest from those chosen so far
+        AVOID       // Goldberg-Werneck: grow into the subtree the bounds cover worst
+    };
+
+    void build(const Graph& graph, int landmarkCount, Selection selection = Selection::AVOID) {
+        build(SearchGraph::fromGraph(graph), landmarkCount, selection);
+    }
+
+    void build(const SearchGraph& graph, int landmarkCount, Selection selection = Selection::AVOID) {
+        nodes = graph.nodeCount();
+        symmetric = graph.undirected;
+        landmarks.clear();
+        forwardTable.clear();
+        backwardTable.clear();
+        if (nodes == 0 || landmarkCount <= 0) return;
+
+        count = std::min<size_t>(static_cast<size_t>(landmarkCount), nodes);
+        forwardTable.assign(nodes * count, INFINITE);
+        if (!symmetric) {
+            backwardTable.assign(nodes * count, INFINITE);
+        }
+
+        SearchGraph reversed{graph.reverse, graph.forward, graph.undirected};
+        Dijkstra forwardSearch(graph);
+        Dijkstra backwardSearch(reversed);
+        std::mt19937 rng(LANDMARK_SEED);
+
+        for (size_t i = 0; i < count; ++i) {
+            int landmark = selection == Selection::AVOID && i > 0
+                ? pickAvoid(forwardSearch, rng)
+                : pickFarthest(forwardSearch, i);
+            landmarks.push_back(landmark);
+
+            forwardSearch.computeAll(landmark);
+            for (size_t v = 0; v < nodes; ++v) {
+                forwardTable[v * count + i] = forwardSearch.getWorkspace().getDistance(static_cast<int>(v));
+            }
+
+            if (!symmetric) {
+                backwardSearch.computeAll(landmark);
+                for (size_t v = 0; v < nodes; ++v) {
+                    backwardTable[v * count + i] = backwardSearch.getWorkspace().getDistance(static_cast<int>(v));
+                }
+            }
+        }
+    }
+
+    bool empty() const { return landmarks.empty(); }
+    size_t nodeCount() const { return nodes; }
+    size_t landmarkCount() const { return landmarks.size(); }
+    const std::vector<int>& getLandmarks() const { return landmarks; }
+
+    // d(landmark, node) and d(node, landmark) for the i-th landmark.
+    float distanceFrom(size_t landmark, int node) const { return forwardTable[node * count + landmark]; }
+    float distanceTo(size_t landmark, int node) const {
+        return symmetric ? forwardTable[node * count + landmark] : backwardTable[node * count + landmark];
+    }
+
+    // One triangle-inequality term; 0 when either distance is unreachable.
+    static float difference(float minuend, float subtrahend) {
+        if (std::isinf(minuend) || std::isinf(subtrahend)) return 0.0f;
+        return minuend - subtrahend;
+    }
+
+    // Largest triangle-inequality bound on d(from, to) over all landmarks.
+    float lowerBound(int from, int to) const {
+        float best = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            best = std::max(best, difference(distanceFrom(i, to), distanceFrom(i, from)));
+            best = std::max(best, difference(distanceTo(i, from), distanceTo(i, to)));
+        }
+        return best;
+    }
+
+    // Layout: "GRLM", version, node count, landmark count, symmetric flag,
+    // landmark nodes, forward table, backward table (if not symmetric).
+    // Values are written in host byte order.
+    void saveToFile(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        writeValue(file, FILE_MAGIC);
+        writeValue(file, FILE_VERSION);
+        writeValue(file, static_cast<std::uint32_t>(nodes));
+        writeValue(file, static_cast<std::uint32_t>(landmarks.size()));
+        writeValue(file, static_cast<std::uint32_t>(symmetric ? 1 : 0));
+        for (int landmark : landmarks) {
+            writeValue(file, static_cast<std::int32_t>(landmark));
+        }
+        file.write(reinterpret_cast<const char*>(forwardTable.data()),
+                   static_cast<std::streamsize>(forwardTable.size() * sizeof(float)));
+        file.write(reinterpret_cast<const char*>(backwardTable.data()),
+                   static_cast<std::streamsize>(backwardTable.size() * sizeof(float)));
+
+        if (!file) {
+            throw std::runtime_error("Failed to write landmark index: " + filename);
+        }
+    }
+
+    // Throws if the file is malformed or was built for a graph of a
+    // different size.
+    void loadFromFile(const std::string& filename, size_t expectedNodeCount) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        std::uint32_t storedNodes = 0;
+        std::uint32_t storedLandmarks = 0;
+        std::uint32_t storedSymmetric = 0;
+        readValue(file, magic);
+        readValue(file, version);
+        readValue(file, storedNodes);
+        readValue(file, storedLandmarks);
+        readValue(file, storedSymmetric);
+        if (!file || magic != FILE_MAGIC || version != FILE_VERSION) {
+            throw std::runtime_error("Not a landmark index file: " + filename);
+        }
+        if (storedNodes != expectedNodeCount) {
+            throw std::runtime_error("Landmark index was built for a different graph: " + filename);
+        }
+
+        nodes = storedNodes;
+        count = storedLandmarks;
+        symmetric = storedSymmetric != 0;
+        landmarks.resize(count);
+        for (int& landmark : landmarks) {
+            std::int32_t stored = 0;
+            readValue(file, stored);
+            landmark = stored;
+        }
+
+        forwardTable.resize(nodes * count);
+        backwardTable.resize(symmetric ? 0 : nodes * count);
+        file.read(reinterpret_cast<char*>(forwardTable.data()),
+                  static_cast<std::streamsize>(forwardTable.size() * sizeof(float)));
+        file.read(reinterpret_cast<char*>(backwardTable.data()),
+                  static_cast<std::streamsize>(backwardTable.size() * sizeof(float)));
+
+        if (!file) {
+            throw std::runtime_error("Truncated landmark index file: " + filename);
+        }
+    }
+
+private:
+    static constexpr float INFINITE = std::numeric_limits<float>::infinity();
+    static constexpr std::uint32_t FILE_MAGIC = 0x4D4C5247;  // "GRLM"
+    static constexpr std::uint32_t FILE_VERSION = 1;
+    static constexpr unsigned LANDMARK_SEED = 12345;
+
+    size_t nodes = 0;
+    size_t count = 0;
+    bool symmetric = false;
+    std::vector<int> landmarks;
+    std::vector<float> forwardTable;    // [node * count + i] = d(landmark i, node)
+    std::vector<float> backwardTable;   // [node * count + i] = d(node, landmark i)
+
+    // Picks the node whose distance to the nearest chosen landmark is
+    // largest; unreached nodes win outright so every component gets one.
+    int pickFarthest(Dijkstra& search, size_t chosen) {
+        if (chosen == 0) {
+            search.computeAll(0);
+            return farthestReached(search);
+        }
+
+        int best = -1;
+        float bestDistance = -1.0f;
+        for (size_t v = 0; v < nodes; ++v) {
+            if (isLandmark(static_cast<int>(v))) continue;
+
+            float nearest = INFINITE;
+            for (size_t i = 0; i < chosen; ++i) {
+                nearest = std::min(nearest, forwardTable[v * count + i]);
+            }
+            if (nearest > bestDistance) {
+                bestDistance = nearest;
+                best = static_cast<int>(v);
+            }
+        }
+        return best;
+    }
+
+    int farthestReached(const Dijkstra& search) const {
+        int best = 0;
+        float bestDistance = -1.0f;
+        for (size_t v = 0; v < nodes; ++v) {
+            float distance = search.getWorkspace().getDistance(static_cast<int>(v));
+            if (!std::isinf(distance) && distance > bestDistance) {
+                bestDistance = distance;
+                best = static_cast<int>(v);
+            }
+        }
+        return best;
+    }
+
+    // Grows a shortest-path tree from a random root and weights each node by
+    // how much the current landmarks underestimate its distance from the
+    // root. Subtrees that already contain a landmark count for nothing; the
+    // new landmark is the leaf reached by always following the heaviest child.
+    int pickAvoid(Dijkstra& search, std::mt19937& rng) {
+        std::uniform_int_distribution<int> pick(0, static_cast<int>(nodes) - 1);
+        const int root = pick(rng);
+
+        std::vector<int> order;
+        search.setQuery(root, -1);
+        while (search.step()) {
+            order.push_back(search.getLastSettled());
+        }
+
+        const SearchWorkspace& tree = search.getWorkspace();
+        std::vector<double> size(nodes, 0.0);
+        std::vector<int> heaviestChild(nodes, -1);
+        std::vector<bool> coversLandmark(nodes, false);
+
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            const int v = *it;
+            if (isLandmark(v)) coversLandmark[v] = true;
+
+            size[v] += tree.getDistance(v) - lowerBound(root, v);
+            if (coversLandmark[v]) size[v] = 0.0;
+
+            const int parent = tree.getParent(v);
+            if (parent < 0) continue;
+            size[parent] += size[v];
+            coversLandmark[parent] = coversLandmark[parent] || coversLandmark[v];
+            if (heaviestChild[parent] < 0 || size[v] > size[heaviestChild[parent]]) {
+                heaviestChild[parent] = v;
+            }
+        }
+
+        int node = root;
+        while (heaviestChild[node] >= 0 && size[heaviestChild[node]] > 0.0) {
+            node = heaviestChild[node];
+        }
+
+        if (node == root || isLandmark(node)) {
+            return pickFarthest(search, landmarks.size());
+        }
+        return node;
+    }
+
+    bool isLandmark(int node) const {
+        return std::find(landmarks.begin(), landmarks.end(), node) != landmarks.end();
+    }
+
+    template <typename T>
+    static void writeValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static void readValue(std::ifstream& file, T& value) {
+        file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+};
+
+// Plugs a LandmarkIndex into ShortestPathSearch / BidirectionalSearch. The
+// anchor's table rows are copied on setTarget()/setSource() so each estimate
+// only reads the row of the node being evaluated.
+class LandmarkHeuristic {
+public:
+    LandmarkHeuristic() = default;
+    explicit LandmarkHeuristic(const LandmarkIndex& landmarkIndex) : index(&landmarkIndex) {}
+
+    // Estimates d(node, target).
+    void setTarget(int node) {
+        anchor(node, false);
+    }
+
+    // Estimates d(source, node).
+    void setSource(int node) {
+        anchor(node, true);
+    }
+
+    float operator()(int node) const {
+        if (!index || anchorNode < 0) return 0.0f;
+
+        // Towards the anchor: d(L,a) - d(L,v) and d(v,L) - d(a,L).
+        // Away from it the roles of the two tables swap.
+        float best = 0.0f;
+        for (size_t i = 0; i < anchorFrom.size(); ++i) {
+            float fromLandmark = index->distanceFrom(i, node);
+            float toLandmark = index->distanceTo(i, node);
+            if (reversed) {
+                best = std::max(best, LandmarkIndex::difference(fromLandmark, anchorFrom[i]));
+                best = std::max(best, LandmarkIndex::difference(anchorTo[i], toLandmark));
+            } else {
+                best = std::max(best, LandmarkIndex::difference(anchorFrom[i], fromLandmark));
+                best = std::max(best, LandmarkIndex::difference(toLandmark, anchorTo[i]));
+            }
+        }
+        return best;
+    }
+
+private:
+    const LandmarkIndex* index = nullptr;
+    int anchorNode = -1;
+    bool reversed = false;
+    std::vector<float> anchorFrom;
+    std::vector<float> anchorTo;
+
+    void anchor(int node, bool fromAnchor) {
+        anchorNode = node;
+        reversed = fromAnchor;
+        if (!index || node < 0) return;
+
+        const size_t count = index->landmarkCount();
+        anchorFrom.resize(count);
+        anchorTo.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            anchorFrom[i] = index->distanceFrom(i, node);
+            anchorTo[i] = index->distanceTo(i, node);
+        }
+    }
+};
+
+// A* with landmark bounds (ALT).
+class ALTSearch : public ShortestPathSearch<LandmarkHeuristic> {
+public:
+    ALTSearch() = default;
+    ALTSearch(const SearchGraph& searchGraph, const LandmarkIndex& landmarks)
+        : ShortestPathSearch(searchGraph, LandmarkHeuristic(landmarks)) {}
+};
@@ -2,55 +2,78 @@
 #include <vector>
 #include <memory>
 #include <string>
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
 #include "MSTVisualization.hpp"
 #include "Node.hpp"
+#include "DisjointSet.hpp"
 
 class MSTAlgorithm : public MSTVisualization {
 protected:
     std::vector<WeightedEdge> edges;
     std::vector<WeightedEdge> mstEdges;
-    std::vector<int> parent;
-    std::vector<int> rank;
+    DisjointSet sets;
+    std::vector<int> nextMember;
     bool finished = false;
 
+    // Puts every node back in a set of its own; makeSet() then resets the
+    // member list and the visual state of each node.
+    void resizeSets(size_t count) {
+        sets.reset(count);
+        nextMember.resize(count);
+    }
+
     void makeSet(int v) {
-        parent[v] = v;
-        rank[v] = 0;
+        nextMember[v] = v;
         setNodeColor(v, MSTColors::UNVISITED);
         setComponentLabel(v, "Component " + std::to_string(v));
     }
 
-    int findSet(int v) {
-        if (v != parent[v])
-            parent[v] = findSet(parent[v]);
-        return parent[v];
+    // Calls visit for every node in v's set. Members form a circular list
+    // through nextMember that unionSets() splices in O(1).
+    template <typename Visit>
+    void forEachMember(int v, Visit&& visit) const {
+        int member = v;
+        do {
+            visit(member);
+            member = nextMember[member];
+        } while (member != v);
     }
 
+    // Node count for the non-visual paths: every node initialize() saw plus
+    // any endpoint of an added edge.
+    int countNodes() const {
+        int nodeCount = static_cast<int>(sets.size());
+        for (const auto& edge : edges) {
+            nodeCount = std::max(nodeCount, std::max(edge.src, edge.dest) + 1);
+        }
+        return nodeCount;
+    }
+
+    // sets.unite() links the smaller set under the larger one. Labels follow
+    // the root, so only the smaller set is relabelled and each node changes
+    // label O(log V) times per run.
     void unionSets(int a, int b) {
-        a = findSet(a);
-        b = findSet(b);
-        if (a != b) {
-            if (rank[a] < rank[b])
-                std::swap(a, b);
-            parent[b] = a;
-            if (rank[a] == rank[b])
-                rank[a]++;
-
-
-            for (size_t i = 0; i < parent.size(); i++) {
-                if (findSet(i) == a) {
-                    setComponentLabel(i, "Component " + std::to_string(a));
-                }
-            }
+        a = sets.find(a);
+        b = sets.find(b);
+        if (!sets.unite(a, b)) return;
+
+        if (isVisualizing()) {
+            const int root = sets.find(a);
+            const std::string label = "Component " + std::to_string(root);
+            forEachMember(root == a ? b : a, [&](int member) { setComponentLabel(member, label); });
         }
+        std::swap(nextMember[a], nextMember[b]);
     }
 
 public:
     virtual ~MSTAlgorithm() = default;
 
-    virtual void execute(std::vector<std::unique_ptr<Node>>& nodes) = 0;
+    // Sets up a step-wise run over nodes 0..nodeCount-1 and the added edges.
+    virtual void initialize(size_t nodeCount) = 0;
+
+    void execute(std::vector<std::unique_ptr<Node>>& nodes) {
+        initialize(nodes.size());
+    }
     virtual std::string getName() const = 0;
     virtual std::string getDescription() const = 0;
     virtual bool step() = 0;
@@ -58,8 +81,8 @@ public:
     virtual void reset() {
         edges.clear();
         mstEdges.clear();
-        parent.clear();
-        rank.clear();
+        sets.reset(0);
+        nextMember.clear();
         nodeStates.clear();
         algorithmSteps.clear();
         currentStep = 0;
@@ -69,13 +92,29 @@ public:
     bool isFinished() const { return finished; }
 
     void addEdge(int src, int dest, float weight) {
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(1);
-        ss << src << " -> " << dest << " (weight: " << weight << ")";
-        edges.push_back({src, dest, weight, ss.str()});
+        edges.push_back({src, dest, weight, static_cast<int>(edges.size())});
     }
 
     const std::vector<WeightedEdge>& getMSTEdges() const {
         return mstEdges;
     }
+
+    // Batch mode: drives the same initialize()/step() logic as the panels
+    // with visualization off, so no node states or step log are written.
+    MSTResult runHeadless(size_t nodeCount) {
+        const bool wasVisualizing = isVisualizing();
+        setVisualizationEnabled(false);
+        initialize(nodeCount);
+        while (!finished) {
+            step();
+        }
+        setVisualizationEnabled(wasVisualizing);
+
+        MSTResult result;
+        result.edges = mstEdges;
+        for (const auto& edge : mstEdges) {
+            result.totalWeight += edge.weight;
+        }
+        return result;
+    }
 };
\ No newline at end of file
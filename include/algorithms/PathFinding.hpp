@@ -1,7 +1,15 @@
 #pragma once
 #include "../Node.hpp"
+#include "../Graph.hpp"
+#include "../AdjacencyIndex.hpp"
+#include "IndexedHeap.hpp"
 #include <vector>
 #include <memory>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <utility>
 
 class PathFindingAlgorithm {
 public:
@@ -11,9 +19,570 @@ public:
     virtual bool isFinished() const = 0;
 };
 
-class Dijkstra : public PathFindingAlgorithm {
+// The arcs a search may follow, over Graph's CSR indices. In an undirected
+// graph every edge can be used both ways, so outgoing and incoming arcs are
+// both the union of the two indices.
+struct SearchGraph {
+    const AdjacencyIndex* forward = nullptr;
+    const AdjacencyIndex* reverse = nullptr;
+    bool undirected = false;
+
+    static SearchGraph fromGraph(const Graph& graph) {
+        return {&graph.getForwardAdjacency(), &graph.getReverseAdjacency(), !graph.isDirected()};
+    }
+
+    size_t nodeCount() const { return forward ? forward->nodeCount() : 0; }
+
+    // visit(target, weight, edgeId) for every arc leaving node.
+    template <typename Visit>
+    void forEachOutgoing(int node, Visit&& visit) const {
+        visitRow(*forward, node, visit);
+        if (undirected) visitRow(*reverse, node, visit);
+    }
+
+    // visit(source, weight, edgeId) for every arc entering node.
+    template <typename Visit>
+    void forEachIncoming(int node, Visit&& visit) const {
+        visitRow(*reverse, node, visit);
+        if (undirected) visitRow(*forward, node, visit);
+    }
+
+private:
+    template <typename Visit>
+    static void visitRow(const AdjacencyIndex& index, int node, Visit& visit) {
+        for (int arc = index.begin(node); arc < index.end(node); ++arc) {
+            visit(index.targets[arc], index.weights[arc], index.edgeIds[arc]);
+        }
+    }
+};
+
+struct PathResult {
+    bool found = false;
+    float distance = std::numeric_limits<float>::infinity();
+    std::vector<int> nodes;     // node indices from source to target
+    std::vector<int> edgeIds;   // Graph::getEdges() positions along the path
+    size_t settledCount = 0;
+};
+
+// Per-node search state that survives between queries. Entries are only valid
+// when their stamp matches the current query, so starting a new query is
+// O(1) instead of clearing arrays sized to the whole graph.
+class SearchWorkspace {
+public:
+    static constexpr float INFINITE_DISTANCE = std::numeric_limits<float>::infinity();
+
+    IndexedHeap<float> heap;
+
+    void prepare(size_t nodeCount) {
+        if (distances.size() != nodeCount) {
+            distances.assign(nodeCount, INFINITE_DISTANCE);
+            parents.assign(nodeCount, -1);
+            parentEdges.assign(nodeCount, -1);
+            potentials.assign(nodeCount, 0.0f);
+            reachedStamps.assign(nodeCount, 0);
+            settledStamps.assign(nodeCount, 0);
+            stamp = 0;
+        }
+        heap.resize(nodeCount);
+
+        if (++stamp == 0) {
+            std::fill(reachedStamps.begin(), reachedStamps.end(), 0);
+            std::fill(settledStamps.begin(), settledStamps.end(), 0);
+            stamp = 1;
+        }
+    }
+
+    size_t nodeCount() const { return distances.size(); }
+    bool isReached(int node) const { return reachedStamps[node] == stamp; }
+    bool isSettled(int node) const { return settledStamps[node] == stamp; }
+    float getDistance(int node) const { return isReached(node) ? distances[node] : INFINITE_DISTANCE; }
+    int getParent(int node) const { return isReached(node) ? parents[node] : -1; }
+    int getParentEdge(int node) const { return isReached(node) ? parentEdges[node] : -1; }
+    // Heuristic estimate cached when the node was first reached (0 for Dijkstra).
+    float getPotential(int node) const { return potentials[node]; }
+
+    void reach(int node, float distance, int parent, int parentEdge, float potential = 0.0f) {
+        reachedStamps[node] = stamp;
+        distances[node] = distance;
+        parents[node] = parent;
+        parentEdges[node] = parentEdge;
+        potentials[node] = potential;
+    }
+
+    void settle(int node) { settledStamps[node] = stamp; }
+
+    // Walks parent links back from target; leaves result untouched if target
+    // was not reached.
+    void extractPath(int target, PathResult& result) const {
+        if (target < 0 || !isReached(target)) return;
+
+        result.found = true;
+        result.distance = distances[target];
+        for (int node = target; node != -1; node = parents[node]) {
+            result.nodes.push_back(node);
+            if (parentEdges[node] != -1) {
+                result.edgeIds.push_back(parentEdges[node]);
+            }
+        }
+        std::reverse(result.nodes.begin(), result.nodes.end());
+        std::reverse(result.edgeIds.begin(), result.edgeIds.end());
+    }
+
+private:
+    std::vector<float> distances;
+    std::vector<int> parents;
+    std::vector<int> parentEdges;
+    std::vector<float> potentials;
+    std::vector<std::uint32_t> reachedStamps;
+    std::vector<std::uint32_t> settledStamps;
+    std::uint32_t stamp = 0;
+};
+
+// Heuristic that never estimates anything, which turns the search into Dijkstra.
+// Heuristics estimate d(node, target) after setTarget(), or d(source, node)
+// after setSource(); the second form drives the backward side of
+// BidirectionalSearch.
+struct ZeroHeuristic {
+    void setTarget(int) {}
+    void setSource(int) {}
+    float operator()(int) const { return 0.0f; }
+};
+
+// A* estimate for graphs whose nodes carry geographic coordinates:
+// scale * haversine(node, target). The scale is the smallest ratio of arc
+// length to great-circle distance over all arcs, so by the triangle
+// inequality the estimate never exceeds the true remaining length, whatever
+// unit the arc lengths use. If any node lacks coordinates the bound cannot be
+// guaranteed, so the estimate falls back to 0.
+class GeoHeuristic {
+public:
+    static GeoHeuristic fromGraph(const Graph& graph) {
+        std::vector<Coordinates> coordinates;
+        coordinates.reserve(graph.getNodes().size());
+        for (const auto& node : graph.getNodes()) {
+            if (!node->hasGeoCoordinates()) return GeoHeuristic();
+            coordinates.push_back(node->getGeoCoordinates());
+        }
+        return fromCoordinates(coordinates, graph.getForwardAdjacency());
+    }
+
+    // coordinates[i] belongs to node index i of arcs.
+    static GeoHeuristic fromCoordinates(const std::vector<Coordinates>& coordinates, const AdjacencyIndex& arcs) {
+        GeoHeuristic heuristic;
+        for (const Coordinates& point : coordinates) {
+            const double latitude = point.latitude * Coordinates::DEGREES_TO_RADIANS;
+            heuristic.latitudes.push_back(latitude);
+            heuristic.longitudes.push_back(point.longitude * Coordinates::DEGREES_TO_RADIANS);
+            heuristic.cosLatitudes.push_back(std::cos(latitude));
+        }
+
+        double scale = std::numeric_limits<double>::infinity();
+        for (int tail = 0; tail < static_cast<int>(arcs.nodeCount()); ++tail) {
+            for (int arc = arcs.begin(tail); arc < arcs.end(tail); ++arc) {
+                double distance = heuristic.haversine(tail, arcs.targets[arc]);
+                if (distance > 0.0) {
+                    scale = std::min(scale, static_cast<double>(std::max(arcs.weights[arc], 0.0f)) / distance);
+                }
+            }
+        }
+
+        // Shrink slightly so float rounding cannot make the estimate overshoot
+        heuristic.scale = std::isfinite(scale) ? scale * (1.0 - 1e-5) : 0.0;
+        return heuristic;
+    }
+
+    double getScale() const { return scale; }
+
+    void setTarget(int node) {
+        target = node >= 0 && static_cast<size_t>(node) < latitudes.size() ? node : -1;
+    }
+
+    // Great-circle distance is symmetric.
+    void setSource(int node) { setTarget(node); }
+
+    float operator()(int node) const {
+        if (target < 0 || scale <= 0.0) return 0.0f;
+        return static_cast<float>(scale * haversine(node, target));
+    }
+
+private:
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::vector<double> cosLatitudes;
+    double scale = 0.0;
+    int target = -1;
+
+    // Radians and latitude cosines are cached per node, since this runs
+    // once per settled node.
+    double haversine(int a, int b) const {
+        return Coordinates::haversineRadians(latitudes[a], longitudes[a], cosLatitudes[a],
+                                             latitudes[b], longitudes[b], cosLatitudes[b]);
+    }
+};
+
+// Best-first shortest-path search over a SearchGraph with an indexed 4-ary
+// heap, keyed by distance plus the heuristic's estimate. Edge weights must be
+// non-negative. Dijkstra and AStar below only differ in the heuristic.
+//
+// findPath() and computeAll() run to completion. For visualization, setQuery()
+// followed by step() settles one node per call and, if nodes were attached,
+// colours the frontier, the settled set and finally the path.
+template <typename Heuristic>
+class ShortestPathSearch : public PathFindingAlgorithm {
+public:
+    ShortestPathSearch() = default;
+    ShortestPathSearch(const SearchGraph& searchGraph, Heuristic estimate = Heuristic())
+        : graph(searchGraph), heuristic(std::move(estimate)) {}
+
+    void setGraph(const SearchGraph& searchGraph) {
+        graph = searchGraph;
+        finished = true;
+    }
+
+    void attachNodes(std::vector<std::unique_ptr<Node>>* visualNodes) {
+        nodes = visualNodes;
+    }
+
+    PathResult findPath(int source, int target) {
+        PathResult result;
+        begin(source, target);
+        while (settleNext() != -1 && !finished) {}
+        result.settledCount = settledCount;
+        workspace.extractPath(target, result);
+        return result;
+    }
+
+    // One-to-all search; read the results through getWorkspace().
+    void computeAll(int source) {
+        begin(source, -1);
+        while (settleNext() != -1) {}
+    }
+
+    void setQuery(int source, int target) {
+        querySource = source;
+        queryTarget = target;
+        reset();
+    }
+
+    void reset() override {
+        if (nodes) {
+            for (auto& node : *nodes) {
+                node->setStateColor(Theme::NODE_FILL);
+                node->setHighlighted(false);
+            }
+        }
+        begin(querySource, queryTarget);
+    }
+
+    bool step() override {
+        if (finished) return false;
+
+        int settled = settleNext();
+        if (nodes && settled != -1) {
+            (*nodes)[settled]->setStateColor(Theme::NODE_COMPLETED);
+            graph.forEachOutgoing(settled, [&](int target, float, int) {
+                if (!workspace.isSettled(target)) {
+                    (*nodes)[target]->setStateColor(Theme::NODE_PROCESSING);
+                }
+            });
+        }
+        if (finished && nodes) {
+            highlightPath();
+        }
+        return settled != -1;
+    }
+
+    bool isFinished() const override { return finished; }
+
+    int getLastSettled() const { return lastSettled; }
+    size_t getSettledCount() const { return settledCount; }
+    const SearchWorkspace& getWorkspace() const { return workspace; }
+
+    PathResult getPath() const {
+        PathResult result;
+        result.settledCount = settledCount;
+        workspace.extractPath(queryTarget, result);
+        return result;
+    }
+
+protected:
+    SearchGraph graph;
+    Heuristic heuristic;
+    SearchWorkspace workspace;
+    std::vector<std::unique_ptr<Node>>* nodes = nullptr;
+    int querySource = -1;
+    int queryTarget = -1;
+    int lastSettled = -1;
+    size_t settledCount = 0;
+    bool finished = true;
+
+    void begin(int source, int target) {
+        queryTarget = target;
+        querySource = source;
+        lastSettled = -1;
+        settledCount = 0;
+        finished = true;
+
+        const size_t nodeCount = graph.nodeCount();
+        if (source < 0 || static_cast<size_t>(source) >= nodeCount) return;
+
+        heuristic.setTarget(target);
+        workspace.prepare(nodeCount);
+        const float potential = heuristic(source);
+        workspace.reach(source, 0.0f, -1, -1, potential);
+        workspace.heap.push(source, potential);
+        finished = false;
+    }
+
+    // Pops and relaxes the most promising open node. Returns it, or -1 if the
+    // heap was empty. A node whose distance still improves after settling
+    // (possible only with an inconsistent estimate) is simply reopened.
+    int settleNext() {
+        if (workspace.heap.empty()) {
+            finished = true;
+            return -1;
+        }
+
+        const int node = workspace.heap.pop();
+        const float distance = workspace.getDistance(node);
+        workspace.settle(node);
+        lastSettled = node;
+        ++settledCount;
+
+        if (node == queryTarget) {
+            finished = true;
+            return node;
+        }
+
+        graph.forEachOutgoing(node, [&](int target, float weight, int edgeId) {
+            float candidate = distance + weight;
+            if (candidate < workspace.getDistance(target)) {
+                float potential = workspace.isReached(target) ? workspace.getPotential(target) : heuristic(target);
+                workspace.reach(target, candidate, node, edgeId, potential);
+                workspace.heap.pushOrDecrease(target, candidate + potential);
+            }
+        });
+
+        if (workspace.heap.empty()) {
+            finished = true;
+        }
+        return node;
+    }
+
+    void highlightPath() {
+        PathResult path = getPath();
+        for (int node : path.nodes) {
+            (*nodes)[node]->setHighlighted(true);
+        }
+    }
+};
+
+class Dijkstra : public ShortestPathSearch<ZeroHeuristic> {
+public:
+    using ShortestPathSearch::ShortestPathSearch;
+};
+
+// Point-to-point A* for map graphs; see GeoHeuristic.
+class AStar : public ShortestPathSearch<GeoHeuristic> {
 public:
-    void reset() override {}
-    bool step() override { return true; }
-    bool isFinished() const override { return true; }
-};
\ No newline at end of file
+    AStar() = default;
+    explicit AStar(const Graph& graph)
+        : ShortestPathSearch(SearchGraph::fromGraph(graph), GeoHeuristic::fromGraph(graph)) {}
+    AStar(const SearchGraph& searchGraph, GeoHeuristic estimate)
+        : ShortestPathSearch(searchGraph, std::move(estimate)) {}
+};
+
+// Point-to-point search that grows a forward tree from the source over
+// outgoing arcs and a backward tree from the target over incoming arcs,
+// always expanding the side with the smaller queue head.
+//
+// With a heuristic, both sides use the average potential
+// p(v) = (h_target(v) - h_source(v)) / 2 forwards and -p(v) backwards, where
+// h_source bounds d(source, v). This keeps the reduced arc lengths of the two
+// searches identical. In that setting the best meeting distance mu is final
+// once the two queue heads sum to at least mu, which is the stopping rule for
+// both plain and A* variants.
+template <typename Heuristic>
+class BidirectionalSearch : public PathFindingAlgorithm {
+public:
+    BidirectionalSearch() = default;
+    BidirectionalSearch(const SearchGraph& searchGraph, Heuristic estimate = Heuristic())
+        : graph(searchGraph), toTarget(estimate), toSource(std::move(estimate)) {}
+
+    void setGraph(const SearchGraph& searchGraph) {
+        graph = searchGraph;
+        finished = true;
+    }
+
+    void attachNodes(std::vector<std::unique_ptr<Node>>* visualNodes) {
+        nodes = visualNodes;
+    }
+
+    PathResult findPath(int source, int target) {
+        begin(source, target);
+        while (!finished) {
+            settleNext();
+        }
+        return getPath();
+    }
+
+    void setQuery(int source, int target) {
+        querySource = source;
+        queryTarget = target;
+        reset();
+    }
+
+    void reset() override {
+        if (nodes) {
+            for (auto& node : *nodes) {
+                node->setStateColor(Theme::NODE_FILL);
+                node->setHighlighted(false);
+            }
+        }
+        begin(querySource, queryTarget);
+    }
+
+    bool step() override {
+        if (finished) return false;
+
+        bool forward = true;
+        int settled = settleNext(&forward);
+        if (nodes && settled != -1) {
+            (*nodes)[settled]->setStateColor(forward ? Theme::NODE_COMPLETED : Theme::NODE_NEW);
+        }
+        if (finished && nodes) {
+            for (int node : getPath().nodes) {
+                (*nodes)[node]->setHighlighted(true);
+            }
+        }
+        return settled != -1;
+    }
+
+    bool isFinished() const override { return finished; }
+    size_t getSettledCount() const { return settledCount; }
+
+    PathResult getPath() const {
+        PathResult result;
+        result.settledCount = settledCount;
+        if (meetingNode < 0) return result;
+
+        forwardSpace.extractPath(meetingNode, result);
+        result.distance = bestDistance;
+
+        for (int node = meetingNode; backwardSpace.getParent(node) != -1; node = backwardSpace.getParent(node)) {
+            result.edgeIds.push_back(backwardSpace.getParentEdge(node));
+            result.nodes.push_back(backwardSpace.getParent(node));
+        }
+        return result;
+    }
+
+protected:
+    SearchGraph graph;
+    Heuristic toTarget;
+    Heuristic toSource;
+    SearchWorkspace forwardSpace;
+    SearchWorkspace backwardSpace;
+    std::vector<std::unique_ptr<Node>>* nodes = nullptr;
+    int querySource = -1;
+    int queryTarget = -1;
+    int meetingNode = -1;
+    float bestDistance = SearchWorkspace::INFINITE_DISTANCE;
+    size_t settledCount = 0;
+    bool finished = true;
+
+    float forwardPotential(int node) const {
+        return (toTarget(node) - toSource(node)) * 0.5f;
+    }
+
+    void begin(int source, int target) {
+        querySource = source;
+        queryTarget = target;
+        meetingNode = -1;
+        bestDistance = SearchWorkspace::INFINITE_DISTANCE;
+        settledCount = 0;
+        finished = true;
+
+        const size_t nodeCount = graph.nodeCount();
+        if (source < 0 || target < 0 || static_cast<size_t>(source) >= nodeCount ||
+            static_cast<size_t>(target) >= nodeCount) {
+            return;
+        }
+
+        toTarget.setTarget(target);
+        toSource.setSource(source);
+        forwardSpace.prepare(nodeCount);
+        backwardSpace.prepare(nodeCount);
+
+        const float sourcePotential = forwardPotential(source);
+        const float targetPotential = -forwardPotential(target);
+        forwardSpace.reach(source, 0.0f, -1, -1, sourcePotential);
+        forwardSpace.heap.push(source, sourcePotential);
+        backwardSpace.reach(target, 0.0f, -1, -1, targetPotential);
+        backwardSpace.heap.push(target, targetPotential);
+        finished = false;
+
+        if (source == target) {
+            meetingNode = source;
+            bestDistance = 0.0f;
+        }
+    }
+
+    // Settles one node on the side with the smaller queue head and returns
+    // it, or -1 once the stopping rule holds.
+    int settleNext(bool* settledForward = nullptr) {
+        const bool forwardEmpty = forwardSpace.heap.empty();
+        const bool backwardEmpty = backwardSpace.heap.empty();
+        if (forwardEmpty || backwardEmpty ||
+            forwardSpace.heap.topKey() + backwardSpace.heap.topKey() >= bestDistance) {
+            finished = true;
+            return -1;
+        }
+
+        const bool forward = forwardSpace.heap.topKey() <= backwardSpace.heap.topKey();
+        if (settledForward) *settledForward = forward;
+
+        SearchWorkspace& space = forward ? forwardSpace : backwardSpace;
+        const SearchWorkspace& other = forward ? backwardSpace : forwardSpace;
+        const float sign = forward ? 1.0f : -1.0f;
+
+        const int node = space.heap.pop();
+        const float distance = space.getDistance(node);
+        space.settle(node);
+        ++settledCount;
+
+        auto relax = [&](int next, float weight, int edgeId) {
+            float candidate = distance + weight;
+            if (!(candidate < space.getDistance(next))) return;
+
+            float potential = space.isReached(next) ? space.getPotential(next) : sign * forwardPotential(next);
+            space.reach(next, candidate, node, edgeId, potential);
+            space.heap.pushOrDecrease(next, candidate + potential);
+
+            if (other.isReached(next) && candidate + other.getDistance(next) < bestDistance) {
+                bestDistance = candidate + other.getDistance(next);
+                meetingNode = next;
+            }
+        };
+
+        if (forward) {
+            graph.forEachOutgoing(node, relax);
+        } else {
+            graph.forEachIncoming(node, relax);
+        }
+        return node;
+    }
+};
+
+class BidirectionalDijkstra : public BidirectionalSearch<ZeroHeuristic> {
+public:
+    using BidirectionalSearch::BidirectionalSearch;
+};
+
+class BidirectionalAStar : public BidirectionalSearch<GeoHeuristic> {
+public:
+    BidirectionalAStar() = default;
+    explicit BidirectionalAStar(const Graph& graph)
+        : BidirectionalSearch(SearchGraph::fromGraph(graph), GeoHeuristic::fromGraph(graph)) {}
+    BidirectionalAStar(const SearchGraph& searchGraph, GeoHeuristic estimate)
+        : BidirectionalSearch(searchGraph, std::move(estimate)) {}
+};
@@ -0,0 +1,284 @@
+#pragma once
+#include "MSTAlgorithm.hpp"
+#include "IndexedHeap.hpp"
+#include "../AdjacencyIndex.hpp"
+#include <limits>
+#include <numeric>
+
+// Prim's algorithm over an undirected adjacency index built from the added
+// edges. Grows one tree at a time from the lowest unvisited node, so a
+// disconnected graph yields a spanning forest.
+class PrimMST : public MSTAlgorithm {
+private:
+    static constexpr float NO_KEY = std::numeric_limits<float>::infinity();
+    static constexpr size_t DENSE_DEGREE_DIVISOR = 16;
+
+    AdjacencyIndex adjacency;
+    IndexedHeap<float> heap;
+    std::vector<float> keys;
+    std::vector<int> bestEdges;
+    std::vector<char> inTree;
+    std::vector<int> remaining;
+    std::vector<int> slots;
+    int nextStart = 0;
+    int currentNode = -1;
+    float totalWeight = 0;
+
+    enum class StepPhase {
+        EXTRACTING,
+        RELAXING
+    } currentStepPhase = StepPhase::EXTRACTING;
+
+public:
+    std::string getName() const override {
+        return "Prim's MST";
+    }
+
+    std::string getDescription() const override {
+        return "Grows the MST from one node by repeatedly adding the cheapest edge leaving the tree";
+    }
+
+    void initialize(size_t nodeCount) override {
+        resizeSets(nodeCount);
+        mstEdges.clear();
+        nodeStates.clear();
+        algorithmSteps.clear();
+        currentStep = 0;
+
+        for (size_t i = 0; i < nodeCount; i++) {
+            setNodeColor(i, MSTColors::UNVISITED);
+            setNodeHighlight(i, false);
+            setPulseEffect(i, 0.0f);
+        }
+
+        prepareSearch();
+        currentNode = -1;
+        currentStepPhase = StepPhase::EXTRACTING;
+        finished = false;
+
+        addAlgorithmStep("Initialized with " + std::to_string(nodeCount) + " nodes and " +
+                        std::to_string(edges.size()) + " edges");
+    }
+
+    bool step() override {
+        if (finished) return false;
+
+        switch (currentStepPhase) {
+            case StepPhase::EXTRACTING:
+                extractCheapestNode();
+                break;
+            case StepPhase::RELAXING:
+                relaxNeighbours();
+                break;
+        }
+
+        return !finished;
+    }
+
+    void reset() override {
+        MSTAlgorithm::reset();
+        adjacency.clear();
+        heap.resize(0);
+        totalWeight = 0;
+        currentNode = -1;
+        currentStepPhase = StepPhase::EXTRACTING;
+    }
+
+    // Picks the dense variant once the average degree reaches
+    // nodeCount / DENSE_DEGREE_DIVISOR, where it overtook the heap.
+    const std::vector<WeightedEdge>& compute() {
+        const size_t nodeCount = static_cast<size_t>(countNodes());
+        if (2 * edges.size() * DENSE_DEGREE_DIVISOR >= nodeCount * nodeCount) {
+            return computeDense();
+        }
+        return computeFast();
+    }
+
+    // Non-visual run with the indexed heap and decrease-key: O(E log V).
+    const std::vector<WeightedEdge>& computeFast() {
+        prepareSearch();
+        const int nodeCount = static_cast<int>(inTree.size());
+
+        for (; nextStart < nodeCount; ++nextStart) {
+            if (inTree[nextStart]) continue;
+            keys[nextStart] = 0;
+            heap.push(nextStart, 0.0f);
+
+            while (!heap.empty()) {
+                const int node = heap.pop();
+                addToTree(node);
+                for (int arc = adjacency.begin(node); arc < adjacency.end(node); ++arc) {
+                    const int next = adjacency.targets[arc];
+                    const float weight = adjacency.weights[arc];
+                    if (!inTree[next] && weight < keys[next]) {
+                        keys[next] = weight;
+                        bestEdges[next] = adjacency.edgeIds[arc];
+                        heap.pushOrDecrease(next, weight);
+                    }
+                }
+            }
+        }
+
+        finished = true;
+        return mstEdges;
+    }
+
+    // Non-visual O(V^2 + E) variant for dense and complete graphs. The
+    // nodes outside the tree and their keys sit in two packed arrays, so
+    // picking the next node is a linear scan with no heap traffic.
+    const std::vector<WeightedEdge>& computeDense() {
+        prepareSearch();
+        const int nodeCount = static_cast<int>(inTree.size());
+
+        remaining.resize(nodeCount);
+        std::iota(remaining.begin(), remaining.end(), 0);
+        slots = remaining;
+
+        while (!remaining.empty()) {
+            size_t best = 0;
+            for (size_t slot = 1; slot < remaining.size(); ++slot) {
+                if (keys[slot] < keys[best]) best = slot;
+            }
+
+            const int node = remaining[best];
+            const int bestEdge = bestEdges[best];
+            remaining[best] = remaining.back();
+            keys[best] = keys[remaining.size() - 1];
+            bestEdges[best] = bestEdges[remaining.size() - 1];
+            slots[remaining[best]] = static_cast<int>(best);
+            remaining.pop_back();
+
+            inTree[node] = 1;
+            if (bestEdge >= 0) {
+                mstEdges.push_back(edges[bestEdge]);
+                totalWeight += edges[bestEdge].weight;
+            }
+
+            for (int arc = adjacency.begin(node); arc < adjacency.end(node); ++arc) {
+                const int next = adjacency.targets[arc];
+                if (inTree[next]) continue;
+                const int slot = slots[next];
+                if (adjacency.weights[arc] < keys[slot]) {
+                    keys[slot] = adjacency.weights[arc];
+                    bestEdges[slot] = adjacency.edgeIds[arc];
+                }
+            }
+        }
+
+        finished = true;
+        return mstEdges;
+    }
+
+    float getTotalWeight() const { return totalWeight; }
+
+private:
+    // Counting-sort build straight from the edge list, one arc per
+    // direction, with edgeIds holding positions in edges.
+    void buildAdjacency(int nodeCount) {
+        adjacency.offsets.assign(nodeCount + 1, 0);
+        for (const auto& edge : edges) {
+            adjacency.offsets[edge.src + 1]++;
+            adjacency.offsets[edge.dest + 1]++;
+        }
+        for (int node = 0; node < nodeCount; ++node) {
+            adjacency.offsets[node + 1] += adjacency.offsets[node];
+        }
+
+        const size_t arcCount = edges.size() * 2;
+        adjacency.targets.resize(arcCount);
+        adjacency.weights.resize(arcCount);
+        adjacency.edgeIds.resize(arcCount);
+
+        std::vector<int> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        auto addArc = [&](int tail, int head, float weight, size_t edgeIndex) {
+            const int slot = cursor[tail]++;
+            adjacency.targets[slot] = head;
+            adjacency.weights[slot] = weight;
+            adjacency.edgeIds[slot] = static_cast<int>(edgeIndex);
+        };
+        for (size_t i = 0; i < edges.size(); ++i) {
+            addArc(edges[i].src, edges[i].dest, edges[i].weight, i);
+            addArc(edges[i].dest, edges[i].src, edges[i].weight, i);
+        }
+    }
+
+    void prepareSearch() {
+        const int nodeCount = countNodes();
+        buildAdjacency(nodeCount);
+        heap.resize(nodeCount);
+        keys.assign(nodeCount, NO_KEY);
+        bestEdges.assign(nodeCount, -1);
+        inTree.assign(nodeCount, 0);
+        mstEdges.clear();
+        totalWeight = 0;
+        nextStart = 0;
+    }
+
+    void addToTree(int node) {
+        inTree[node] = 1;
+        if (bestEdges[node] >= 0) {
+            const WeightedEdge& edge = edges[bestEdges[node]];
+            mstEdges.push_back(edge);
+            totalWeight += edge.weight;
+        }
+    }
+
+    void extractCheapestNode() {
+        if (currentNode >= 0) {
+            setNodeHighlight(currentNode, false);
+            setPulseEffect(currentNode, 0.0f);
+        }
+
+        if (heap.empty()) {
+            const int nodeCount = static_cast<int>(inTree.size());
+            while (nextStart < nodeCount && inTree[nextStart]) ++nextStart;
+            if (nextStart >= nodeCount) {
+                finishRun();
+                return;
+            }
+            keys[nextStart] = 0;
+            heap.push(nextStart, 0.0f);
+        }
+
+        const int node = heap.pop();
+        addToTree(node);
+        currentNode = node;
+        setNodeColor(node, MSTColors::IN_MST);
+        setNodeHighlight(node, true);
+        setPulseEffect(node, 1.0f);
+
+        if (isVisualizing()) {
+            addAlgorithmStep(bestEdges[node] >= 0 ? "Added edge " + describeEdge(edges[bestEdges[node]])
+                                                  : "Growing a new tree from node " + std::to_string(node));
+        }
+        currentStepPhase = StepPhase::RELAXING;
+    }
+
+    void relaxNeighbours() {
+        int updated = 0;
+        for (int arc = adjacency.begin(currentNode); arc < adjacency.end(currentNode); ++arc) {
+            const int next = adjacency.targets[arc];
+            const float weight = adjacency.weights[arc];
+            if (!inTree[next] && weight < keys[next]) {
+                keys[next] = weight;
+                bestEdges[next] = adjacency.edgeIds[arc];
+                heap.pushOrDecrease(next, weight);
+                setNodeColor(next, MSTColors::CONSIDERING);
+                ++updated;
+            }
+        }
+
+        if (isVisualizing()) {
+            addAlgorithmStep("Lowered the key of " + std::to_string(updated) + " neighbour(s) of node " +
+                            std::to_string(currentNode));
+        }
+        currentStepPhase = StepPhase::EXTRACTING;
+    }
+
+    void finishRun() {
+        currentNode = -1;
+        finished = true;
+        addAlgorithmStep("Algorithm completed! MST has " + std::to_string(mstEdges.size()) +
+                        " edges, total weight " + formatWeight(totalWeight));
+    }
+};
@@ -128,6 +128,18 @@ void Application::handleKeyPress(const sf::Event::KeyEvent& key) {
         return;
     }
 
+    if (key.code == sf::Keyboard::T) {
+        graph.setAsyncLayout(!graph.isAsyncLayout());
+        std::cout << "Background layout: " << (graph.isAsyncLayout() ? "on" : "off") << std::endl;
+        return;
+    }
+
+    if (key.code == sf::Keyboard::P) {
+        graph.setLayoutThreadCount(graph.getLayoutThreadCount() > 1 ? 1 : 0);
+        std::cout << "Layout threads: " << graph.getLayoutThreadCount() << std::endl;
+        return;
+    }
+
     if (key.control) {
         switch (key.code) {
             case sf::Keyboard::S:
@@ -198,13 +210,14 @@ void Application::handleMouseRelease(const sf::Event::MouseButtonEvent& mouseBut
     }
     isDragging = false;
     draggedNode = nullptr;
+    graph.releaseNode();
 }
 
 void Application::handleMouseMove(const sf::Event& event) {
     if (isDragging && draggedNode) {
         sf::Vector2i screenPos(event.mouseMove.x, event.mouseMove.y);
         sf::Vector2f worldPos = viewportManager->screenToWorld(screenPos);
-        draggedNode->setPosition(worldPos);
+        graph.dragNode(draggedNode, worldPos);
         updateViewportBounds(worldPos);
     }
 }
@@ -1,9 +1,84 @@
 #include "Node.hpp"
+#include "GlyphLayout.hpp"
 #include <iostream>
+#include <array>
+#include <cmath>
 
 sf::Font Node::font;
 bool Node::fontLoaded = false;
 
+namespace {
+    const sf::Color HIGHLIGHT_GLOW(255, 255, 0, 100);
+    const sf::Color STATUS_BACKGROUND(0, 0, 0, 150);
+    const float GLOW_OFFSET = 5.f;
+    const float GLOW_THICKNESS = 8.f;
+
+    // Same point placement as sf::CircleShape's default 30 points.
+    constexpr size_t CIRCLE_POINTS = 30;
+    // One disc (3 vertices per point) and one outline ring (6 per point)
+    static_assert(Node::SHAPE_VERTEX_COUNT == 9 * CIRCLE_POINTS);
+
+    const std::array<sf::Vector2f, CIRCLE_POINTS>& unitCircle() {
+        static const std::array<sf::Vector2f, CIRCLE_POINTS> points = [] {
+            std::array<sf::Vector2f, CIRCLE_POINTS> result;
+            for (size_t i = 0; i < CIRCLE_POINTS; ++i) {
+                float angle = static_cast<float>(i) * 2.f * 3.14159265f / CIRCLE_POINTS - 3.14159265f / 2.f;
+                result[i] = sf::Vector2f(std::cos(angle), std::sin(angle));
+            }
+            return result;
+        }();
+        return points;
+    }
+
+    void appendDisc(std::vector<sf::Vertex>& out, sf::Vector2f center, float radius, const sf::Color& color) {
+        const auto& points = unitCircle();
+        for (size_t i = 0; i < CIRCLE_POINTS; ++i) {
+            const sf::Vector2f& a = points[i];
+            const sf::Vector2f& b = points[(i + 1) % CIRCLE_POINTS];
+            out.emplace_back(center, color);
+            out.emplace_back(center + a * radius, color);
+            out.emplace_back(center + b * radius, color);
+        }
+    }
+
+    void appendRing(std::vector<sf::Vertex>& out, sf::Vector2f center, float innerRadius,
+                    float thickness, const sf::Color& color) {
+        const auto& points = unitCircle();
+        const float outerRadius = innerRadius + thickness;
+        for (size_t i = 0; i < CIRCLE_POINTS; ++i) {
+            const sf::Vector2f& a = points[i];
+            const sf::Vector2f& b = points[(i + 1) % CIRCLE_POINTS];
+            out.emplace_back(center + a * innerRadius, color);
+            out.emplace_back(center + a * outerRadius, color);
+            out.emplace_back(center + b * outerRadius, color);
+            out.emplace_back(center + a * innerRadius, color);
+            out.emplace_back(center + b * outerRadius, color);
+            out.emplace_back(center + b * innerRadius, color);
+        }
+    }
+
+    void appendQuad(std::vector<sf::Vertex>& out, sf::Vector2f topLeft, sf::Vector2f bottomRight,
+                    const sf::Color& color) {
+        sf::Vector2f topRight(bottomRight.x, topLeft.y);
+        sf::Vector2f bottomLeft(topLeft.x, bottomRight.y);
+        out.emplace_back(topLeft, color);
+        out.emplace_back(topRight, color);
+        out.emplace_back(bottomRight, color);
+        out.emplace_back(topLeft, color);
+        out.emplace_back(bottomRight, color);
+        out.emplace_back(bottomLeft, color);
+    }
+
+    void appendTransformed(std::vector<sf::Vertex>& out, const std::vector<sf::Vertex>& glyphs,
+                           sf::Vector2f offset, float scale, sf::Vector2f position) {
+        for (const sf::Vertex& glyph : glyphs) {
+            sf::Vertex vertex = glyph;
+            vertex.position = position + (glyph.position + offset) * scale;
+            out.push_back(vertex);
+        }
+    }
+}
+
 Node::Node(float x, float y, int id)
     : id(id), selected(false), highlighted(false), currentScale(1.0f),
       currentColor(Theme::NODE_FILL) {
@@ -23,67 +98,63 @@ Node::Node(float x, float y, int id)
         }
     }
 
+    // Glyphs are stored relative to the label origin, centred on the node
+    if (fontLoaded) {
+        sf::FloatRect bounds = GlyphLayout::appendString(labelGlyphs, font, std::to_string(id),
+                                                         LABEL_CHARACTER_SIZE, true, sf::Color::Black);
+        GlyphLayout::translate(labelGlyphs, 0, sf::Vector2f(-bounds.width / 2, -bounds.height / 2));
+    }
+}
 
-    label.setFont(font);
-    label.setString(std::to_string(id));
-    label.setCharacterSize(24);
-    label.setFillColor(sf::Color::Black);
-    label.setStyle(sf::Text::Bold);
-
+const sf::Texture& Node::getLabelTexture() {
+    return font.getTexture(LABEL_CHARACTER_SIZE);
+}
 
-    statusLabel.setFont(font);
-    statusLabel.setCharacterSize(14);
-    statusLabel.setFillColor(sf::Color::White);
+const sf::Texture& Node::getStatusTexture() {
+    return font.getTexture(STATUS_CHARACTER_SIZE);
+}
 
-    updateLabelPositions();
+void Node::appendShapeGeometry(std::vector<sf::Vertex>& out) const {
+    const sf::Vector2f center = shape.getPosition();
+    const float radius = shape.getRadius() * currentScale;
+    appendDisc(out, center, radius, shape.getFillColor());
+    appendRing(out, center, radius, shape.getOutlineThickness() * currentScale, shape.getOutlineColor());
 }
 
-void Node::draw(sf::RenderTarget& target) {
+void Node::appendGlowGeometry(std::vector<sf::Vertex>& out) const {
+    const sf::Vector2f center = shape.getPosition();
+    const float glowRadius = (Theme::NODE_RADIUS + GLOW_OFFSET) * currentScale;
 
     if (highlighted) {
-        sf::CircleShape glow = shape;
-        glow.setRadius(Theme::NODE_RADIUS + 5.f);
-        glow.setOrigin(Theme::NODE_RADIUS + 5.f, Theme::NODE_RADIUS + 5.f);
-        glow.setPosition(shape.getPosition());
-        glow.setFillColor(sf::Color::Transparent);
-        glow.setOutlineColor(sf::Color(255, 255, 0, 100));
-        glow.setOutlineThickness(8.f);
-        target.draw(glow);
+        appendRing(out, center, glowRadius, GLOW_THICKNESS * currentScale, HIGHLIGHT_GLOW);
     }
 
-
     if (selected) {
-        sf::CircleShape selectionGlow = shape;
-        selectionGlow.setRadius(Theme::NODE_RADIUS + 5.f);
-        selectionGlow.setOrigin(Theme::NODE_RADIUS + 5.f, Theme::NODE_RADIUS + 5.f);
-        selectionGlow.setPosition(shape.getPosition());
-        selectionGlow.setFillColor(sf::Color::Transparent);
-        selectionGlow.setOutlineColor(sf::Color(Theme::NODE_SELECTED.r,
-                                     Theme::NODE_SELECTED.g,
-                                     Theme::NODE_SELECTED.b,
-                                     100));
-        selectionGlow.setOutlineThickness(8.f);
-        target.draw(selectionGlow);
+        sf::Color selectionGlow(Theme::NODE_SELECTED.r, Theme::NODE_SELECTED.g, Theme::NODE_SELECTED.b, 100);
+        appendRing(out, center, glowRadius, GLOW_THICKNESS * currentScale, selectionGlow);
     }
+}
+
+void Node::appendLabelGeometry(std::vector<sf::Vertex>& out) const {
+    appendTransformed(out, labelGlyphs, sf::Vector2f(0.f, 0.f), currentScale, shape.getPosition());
+}
 
-    target.draw(shape);
-    target.draw(label);
+void Node::appendStatusGeometry(std::vector<sf::Vertex>& backgrounds, std::vector<sf::Vertex>& labels) const {
+    if (statusGlyphs.empty()) return;
 
-    if (!statusLabel.getString().isEmpty()) {
+    // The background is anchored at the node centre and is not scaled
+    const sf::Vector2f center = shape.getPosition();
+    appendQuad(backgrounds,
+               center - sf::Vector2f(statusBounds.width / 2 + 5, statusBounds.height + 5),
+               center + sf::Vector2f(statusBounds.width / 2 + 5, 5),
+               STATUS_BACKGROUND);
 
-        sf::FloatRect bounds = statusLabel.getLocalBounds();
-        sf::RectangleShape background;
-        background.setSize(sf::Vector2f(bounds.width + 10, bounds.height + 10));
-        background.setOrigin(bounds.width/2 + 5, bounds.height + 5);
-        background.setPosition(statusLabel.getPosition());
-        background.setFillColor(sf::Color(0, 0, 0, 150));
-        target.draw(background);
-        target.draw(statusLabel);
-    }
+    sf::Vector2f lift(0.f, -(shape.getRadius() * currentScale + 15));
+    appendTransformed(labels, statusGlyphs, lift, currentScale, center);
 }
 
 bool Node::contains(sf::Vector2f point) const {
-    sf::Vector2f center = shape.getPosition();
+    sf::Vector2f center = getPosition();
     float dx = point.x - center.x;
     float dy = point.y - center.y;
     float distanceSquared = dx * dx + dy * dy;
@@ -92,19 +163,30 @@ bool Node::contains(sf::Vector2f point) const {
 }
 
 void Node::setPosition(sf::Vector2f newPos) {
+    if (layoutStore) {
+        layoutStore->x[layoutSlot] = newPos.x;
+        layoutStore->y[layoutSlot] = newPos.y;
+        ++layoutStore->versions[layoutSlot];
+    } else {
+        ++positionVersion;
+    }
     shape.setPosition(newPos);
-    updateLabelPositions();
+    touch();
 }
 
 void Node::setSelected(bool isSelected) {
     if (selected != isSelected) {
         selected = isSelected;
         createSelectionAnimation();
+        touch();
     }
 }
 
 void Node::setHighlighted(bool isHighlighted) {
-    highlighted = isHighlighted;
+    if (highlighted != isHighlighted) {
+        highlighted = isHighlighted;
+        touch();
+    }
 }
 
 void Node::setColor(const sf::Color& color) {
@@ -115,8 +197,14 @@ void Node::setColor(const sf::Color& color) {
 }
 
 void Node::setStatusLabel(const std::string& status) {
-    statusLabel.setString(status);
-    updateLabelPositions();
+    statusGlyphs.clear();
+    statusBounds = sf::FloatRect();
+    if (!status.empty() && fontLoaded) {
+        statusBounds = GlyphLayout::appendString(statusGlyphs, font, status, STATUS_CHARACTER_SIZE,
+                                                 false, sf::Color::White);
+        GlyphLayout::translate(statusGlyphs, 0, sf::Vector2f(-statusBounds.width / 2, -statusBounds.height));
+    }
+    touch();
 }
 
 void Node::update(float deltaTime) {
@@ -152,6 +240,7 @@ void Node::createSelectionAnimation() {
                 color.a = static_cast<sf::Uint8>(255 * (1.0f - progress));
                 shape.setOutlineColor(color);
             }
+            touch();
         }
     );
 }
@@ -168,6 +257,7 @@ void Node::createColorAnimation(const sf::Color& newColor) {
             currentColor.b = static_cast<sf::Uint8>(startColor.b + (newColor.b - startColor.b) * progress);
             currentColor.a = static_cast<sf::Uint8>(startColor.a + (newColor.a - startColor.a) * progress);
             shape.setFillColor(currentColor);
+            touch();
         }
     );
 }
\ No newline at end of file